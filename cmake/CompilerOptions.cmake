@@ -35,6 +35,14 @@ if(KCC_USE_LIBCXX)
   endif()
 endif()
 
+# ---------------------------------------------------------------------------------------
+# SIMD
+# ---------------------------------------------------------------------------------------
+if(KCC_AVX2)
+  message(STATUS "Use AVX2")
+  add_cxx_compiler_flag("-mavx2")
+endif()
+
 # ---------------------------------------------------------------------------------------
 # Sanitizer
 # ---------------------------------------------------------------------------------------
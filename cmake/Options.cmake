@@ -5,6 +5,8 @@ option(KCC_CLANG_TIDY "Analyze code with clang-tidy" OFF)
 
 option(KCC_USE_LIBCXX "Use libc++" OFF)
 
+option(KCC_AVX2 "Use AVX2 in the lexer (SSE2 is used otherwise)" OFF)
+
 include(CMakeDependentOption)
 cmake_dependent_option(
   KCC_BUILD_COVERAGE "Build tests with coverage information" OFF
@@ -0,0 +1,143 @@
+//
+// Created by kaiser on 2026/10/16.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace kcc {
+
+// 指针碰撞分配器, 分配的内存在 Reset 时一起释放
+class Arena {
+ public:
+  Arena() = default;
+  ~Arena();
+
+  Arena(const Arena &) = delete;
+  Arena &operator=(const Arena &) = delete;
+
+  // 返回的内存需要立即构造 T (同 boost::object_pool::malloc)
+  // 不能平凡析构的 T 在 Reset 时调用析构函数
+  template <typename T>
+  void *Allocate() {
+    auto ptr{Allocate(sizeof(T), alignof(T))};
+
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      destructors_.push_back(
+          {ptr, [](void *object) { static_cast<T *>(object)->~T(); }});
+    }
+
+    return ptr;
+  }
+
+  template <typename T>
+  T *AllocateArray(std::size_t size) {
+    static_assert(std::is_trivially_destructible_v<T>);
+    return static_cast<T *>(Allocate(sizeof(T) * size, alignof(T)));
+  }
+
+  void *Allocate(std::size_t size, std::size_t align) {
+    auto ptr{AlignUp(ptr_, align)};
+    if (size > static_cast<std::size_t>(end_ - ptr)) {
+      return AllocateSlow(size, align);
+    }
+
+    ptr_ = ptr + size;
+    return ptr;
+  }
+
+  // 按分配的逆序调用析构函数, 释放所有的内存
+  void Reset();
+
+ private:
+  struct Destructor {
+    void *object;
+    void (*destroy)(void *);
+  };
+
+  static std::byte *AlignUp(std::byte *ptr, std::size_t align);
+  void *AllocateSlow(std::size_t size, std::size_t align);
+
+  constexpr static std::size_t SlabSize{64 * 1024};
+
+  std::byte *ptr_{};
+  std::byte *end_{};
+
+  std::vector<std::unique_ptr<std::byte[]>> slabs_;
+  std::vector<Destructor> destructors_;
+};
+
+// 当前编译上下文的 Arena, AST, 类型和作用域都在这里分配,
+// 编译上下文销毁时一起释放, 见 context.h
+Arena &AstArena();
+
+// 在 AstArena 中分配的数组, 可以平凡析构, 因此不需要注册析构函数
+// 扩容时旧的空间不会释放, 适合只追加的短数组
+template <typename T>
+class ArenaVector {
+  static_assert(std::is_trivially_copyable_v<T>);
+
+ public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using iterator = T *;
+  using const_iterator = const T *;
+
+  ArenaVector() = default;
+  explicit ArenaVector(std::span<const T> values) {
+    if (!std::empty(values)) {
+      Reserve(std::size(values));
+      std::memcpy(data_, std::data(values), std::size(values) * sizeof(T));
+      size_ = std::size(values);
+    }
+  }
+
+  // 复制后共享同一块空间, 容易出错
+  ArenaVector(const ArenaVector &) = delete;
+  ArenaVector &operator=(const ArenaVector &) = delete;
+
+  void push_back(const T &value) {
+    if (size_ == capacity_) {
+      Reserve(capacity_ == 0 ? 4 : capacity_ * 2);
+    }
+    data_[size_++] = value;
+  }
+
+  iterator begin() { return data_; }
+  iterator end() { return data_ + size_; }
+  const_iterator begin() const { return data_; }
+  const_iterator end() const { return data_ + size_; }
+
+  T &operator[](size_type index) { return data_[index]; }
+  const T &operator[](size_type index) const { return data_[index]; }
+  T &front() { return data_[0]; }
+  const T &front() const { return data_[0]; }
+  T &back() { return data_[size_ - 1]; }
+  const T &back() const { return data_[size_ - 1]; }
+
+  size_type size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+ private:
+  void Reserve(size_type capacity) {
+    auto data{AstArena().AllocateArray<T>(capacity)};
+    if (size_ != 0) {
+      std::memcpy(data, data_, size_ * sizeof(T));
+    }
+
+    data_ = data;
+    capacity_ = capacity;
+  }
+
+  T *data_{};
+  size_type size_{};
+  size_type capacity_{};
+};
+
+}  // namespace kcc
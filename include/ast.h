@@ -19,7 +19,9 @@
 #include <llvm/IR/GlobalValue.h>
 #include <llvm/IR/Instructions.h>
 
+#include "arena.h"
 #include "location.h"
+#include "symbol.h"
 #include "token.h"
 #include "type.h"
 
@@ -30,13 +32,6 @@ class CompoundStmt;
 class Declaration;
 class Visitor;
 
-// arr / ptr
-inline std::unordered_map<std::string,
-                          std::pair<llvm::Constant *, llvm::Constant *>>
-    StringMap;
-
-inline std::unordered_map<std::string, llvm::GlobalVariable *> GlobalVarMap;
-
 enum class AstNodeType {
   kUnaryOpExpr,
   kTypeCastExpr,
@@ -72,8 +67,6 @@ enum class AstNodeType {
 
 class AstNode {
  public:
-  virtual ~AstNode() = default;
-
   virtual AstNodeType Kind() const = 0;
   virtual void Accept(Visitor &visitor) const = 0;
   virtual void Check() = 0;
@@ -85,6 +78,9 @@ class AstNode {
 
  protected:
   AstNode() = default;
+  // 在 AstArena 中分配, 不会通过基类指针删除
+  // 成员都可以平凡析构的类也可以平凡析构, 不需要注册析构函数
+  ~AstNode() = default;
 
   Location loc_;
 };
@@ -241,7 +237,7 @@ class FuncCallExpr : public Expr {
   Type *GetFuncType() const;
 
   Expr *GetCallee() const;
-  const std::vector<Expr *> &GetArgs() const;
+  const ArenaVector<Expr *> &GetArgs() const;
 
   void SetVaArgType(Type *va_arg_type);
   Type *GetVaArgType() const;
@@ -250,7 +246,7 @@ class FuncCallExpr : public Expr {
   explicit FuncCallExpr(Expr *callee, std::vector<Expr *> args = {});
 
   Expr *callee_;
-  std::vector<Expr *> args_;
+  ArenaVector<Expr *> args_;
 
   Type *va_arg_type_{nullptr};
 };
@@ -316,7 +312,7 @@ enum class Linkage { kNone, kInternal, kExternal };
 // 宏名或宏形参名以外的每个标识符都拥有作用域，并且可以拥有链接
 class IdentifierExpr : public Expr {
  public:
-  static IdentifierExpr *Get(const std::string &name, QualType type,
+  static IdentifierExpr *Get(Symbol name, QualType type,
                              enum Linkage linkage = Linkage::kNone,
                              bool is_type_name = false);
 
@@ -327,6 +323,7 @@ class IdentifierExpr : public Expr {
 
   enum Linkage GetLinkage() const;
   const std::string &GetName() const;
+  Symbol GetSymbol() const;
   bool IsTypeName() const;
   bool IsObject() const;
 
@@ -334,18 +331,18 @@ class IdentifierExpr : public Expr {
   const ObjectExpr *ToObjectExpr() const;
 
  protected:
-  IdentifierExpr(const std::string &name, QualType type,
+  IdentifierExpr(Symbol name, QualType type,
                  enum Linkage linkage = Linkage::kNone,
                  bool is_type_name = false);
 
-  std::string name_;
+  Symbol name_;
   enum Linkage linkage_;
   bool is_type_name_;
 };
 
 class EnumeratorExpr : public IdentifierExpr {
  public:
-  static EnumeratorExpr *Get(const std::string &name, std::int32_t val);
+  static EnumeratorExpr *Get(Symbol name, std::int32_t val);
 
   virtual AstNodeType Kind() const override;
   virtual void Accept(Visitor &visitor) const override;
@@ -355,7 +352,7 @@ class EnumeratorExpr : public IdentifierExpr {
   std::int32_t GetVal() const;
 
  private:
-  EnumeratorExpr(const std::string &name, std::int32_t val);
+  EnumeratorExpr(Symbol name, std::int32_t val);
 
   std::int32_t val_;
 };
@@ -371,7 +368,7 @@ class EnumeratorExpr : public IdentifierExpr {
 // 可选项: 表示该对象的标识符
 class ObjectExpr : public IdentifierExpr {
  public:
-  static ObjectExpr *Get(const std::string &name, QualType type,
+  static ObjectExpr *Get(Symbol name, QualType type,
                          std::uint32_t storage_class_spec = 0,
                          enum Linkage linkage = Linkage::kNone,
                          bool anonymous = false,
@@ -415,7 +412,7 @@ class ObjectExpr : public IdentifierExpr {
   void SetFuncName(const std::string &func_name);
 
  private:
-  ObjectExpr(const std::string &name, QualType type,
+  ObjectExpr(Symbol name, QualType type,
              std::uint32_t storage_class_spec = 0,
              enum Linkage linkage = Linkage::kNone, bool anonymous = false,
              std::int32_t bit_field_width = 0);
@@ -465,7 +462,7 @@ class Stmt : public AstNode {
 
 class LabelStmt : public Stmt {
  public:
-  static LabelStmt *Get(const std::string &name, Stmt *stmt);
+  static LabelStmt *Get(Symbol name, Stmt *stmt);
 
   virtual AstNodeType Kind() const override;
   virtual void Accept(Visitor &visitor) const override;
@@ -474,11 +471,12 @@ class LabelStmt : public Stmt {
 
   Stmt *GetStmt() const;
   const std::string &GetName() const;
+  Symbol GetSymbol() const;
 
  private:
-  explicit LabelStmt(const std::string &name, Stmt *stmt);
+  explicit LabelStmt(Symbol name, Stmt *stmt);
 
-  std::string name_;
+  Symbol name_;
   Stmt *stmt_;
 };
 
@@ -533,14 +531,14 @@ class CompoundStmt : public Stmt {
   virtual void Check() override;
   virtual std::vector<Stmt *> Children() const override;
 
-  const std::vector<Stmt *> &GetStmts() const;
+  const ArenaVector<Stmt *> &GetStmts() const;
   void AddStmt(Stmt *stmt);
 
  private:
   CompoundStmt() = default;
   explicit CompoundStmt(std::vector<Stmt *> stmts);
 
-  std::vector<Stmt *> stmts_;
+  ArenaVector<Stmt *> stmts_;
 };
 
 class ExprStmt : public Stmt {
@@ -663,7 +661,7 @@ class ForStmt : public Stmt {
 
 class GotoStmt : public Stmt {
  public:
-  static GotoStmt *Get(const std::string &name);
+  static GotoStmt *Get(Symbol name);
   static GotoStmt *Get(LabelStmt *label);
 
   virtual AstNodeType Kind() const override;
@@ -673,12 +671,13 @@ class GotoStmt : public Stmt {
   const LabelStmt *GetLabel() const;
   void SetLabel(LabelStmt *label);
   const std::string &GetName() const;
+  Symbol GetSymbol() const;
 
  private:
-  explicit GotoStmt(const std::string &name);
+  explicit GotoStmt(Symbol name);
   explicit GotoStmt(LabelStmt *ident);
 
-  std::string name_;
+  Symbol name_;
   LabelStmt *label_{};
 };
 
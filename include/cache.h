@@ -0,0 +1,33 @@
+//
+// Created by kaiser on 2026/10/16.
+//
+
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "token.h"
+
+namespace kcc {
+
+// 编译缓存
+// 目标文件完全由预处理后的记号序列和编译选项决定, 以其哈希值为键保存目标文件,
+// 命中时跳过语法分析, 代码生成, 优化以及目标代码生成
+const std::filesystem::path &GetCacheDir();
+
+std::string GetCacheKey(const std::string &file_name,
+                        const std::vector<Token> &tokens);
+
+// 命中时将缓存的目标文件复制到 obj_file
+bool CacheLookup(const std::string &key, const std::string &obj_file);
+
+void CacheStore(const std::string &key, const std::string &obj_file);
+
+// 超出 -cache-size 时按最近使用时间淘汰
+void CacheTrim();
+
+void PrintCacheStatistics();
+
+}  // namespace kcc
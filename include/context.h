@@ -0,0 +1,112 @@
+//
+// Created by kaiser on 2026/10/16.
+//
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <clang/Basic/TargetInfo.h>
+#include <clang/Frontend/CompilerInstance.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/GlobalVariable.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Target/TargetMachine.h>
+
+#include "arena.h"
+#include "error.h"
+#include "location.h"
+#include "type.h"
+
+namespace kcc {
+
+// 一个翻译单元的编译上下文, 拥有编译它所需的全部状态
+// 上下文不绑定线程, 由 ContextScope 设置为某个线程当前的上下文,
+// 因此同一个线程可以依次编译多个翻译单元
+struct CompilationContext {
+  CompilationContext();
+
+  CompilationContext(const CompilationContext &) = delete;
+  CompilationContext &operator=(const CompilationContext &) = delete;
+
+  // 拥有许多 LLVM 核心数据结构, 如类型和常量值表
+  llvm::LLVMContext context;
+  // 一个辅助对象, 跟踪当前位置并且可以插入 LLVM 指令
+  llvm::IRBuilder<> builder{context};
+  // 包含函数和全局变量, 它拥有生成的所有 IR 的内存
+  std::unique_ptr<llvm::Module> module;
+
+  // clang 的 FileManager 不是线程安全的, 每个上下文有自己的一份
+  clang::CompilerInstance ci;
+  clang::TargetInfo *target_info;
+  std::unique_ptr<llvm::TargetMachine> target_machine;
+
+  // AST, 类型和作用域都在这里分配, 上下文销毁时一起释放
+  Arena ast_arena;
+  TypeTable types;
+
+  // arr / ptr
+  std::unordered_map<std::string,
+                     std::pair<llvm::Constant *, llvm::Constant *>>
+      string_map;
+  std::unordered_map<std::string, llvm::GlobalVariable *> global_var_map;
+
+  // 文件表, 偏移 0 保留给无效的位置
+  std::vector<SourceFile> files;
+  std::uint32_t next_begin{1};
+
+  // 驻留表, std::deque 添加元素时不会移动已有的元素,
+  // 键可以直接引用其中的字符串
+  std::deque<std::string> names;
+  std::unordered_map<std::string_view, const std::string *> symbols;
+
+  std::vector<PendingWarning> warnings;
+};
+
+// 当前线程正在编译的翻译单元, 不在任何翻译单元中时为 nullptr
+inline thread_local CompilationContext *CurrentContext{};
+
+// 在作用域内把 context 设置为当前线程的编译上下文
+class ContextScope {
+ public:
+  explicit ContextScope(CompilationContext &context)
+      : prev_{std::exchange(CurrentContext, &context)} {}
+  ~ContextScope() { CurrentContext = prev_; }
+
+  ContextScope(const ContextScope &) = delete;
+  ContextScope &operator=(const ContextScope &) = delete;
+
+ private:
+  CompilationContext *prev_;
+};
+
+inline CompilationContext &GetContext() {
+  assert(CurrentContext != nullptr);
+  return *CurrentContext;
+}
+
+inline llvm::LLVMContext &Context() { return GetContext().context; }
+
+inline llvm::IRBuilder<> &Builder() { return GetContext().builder; }
+
+inline llvm::Module &Module() { return *GetContext().module; }
+
+inline clang::CompilerInstance &Ci() { return GetContext().ci; }
+
+inline clang::TargetInfo &TargetInfo() { return *GetContext().target_info; }
+
+inline llvm::TargetMachine &TargetMachine() {
+  return *GetContext().target_machine;
+}
+
+}  // namespace kcc
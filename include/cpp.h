@@ -5,11 +5,25 @@
 #pragma once
 
 #include <cstddef>
+#include <memory>
+#include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include <clang/Basic/SourceLocation.h>
 #include <clang/Lex/HeaderSearch.h>
 #include <clang/Lex/Preprocessor.h>
+#include <clang/Lex/Token.h>
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/Allocator.h>
+#include <llvm/Support/StringSaver.h>
+
+#include "dict.h"
+#include "header_cache.h"
+#include "location.h"
+#include "pch.h"
+#include "token.h"
 
 namespace kcc {
 
@@ -22,14 +36,51 @@ class Preprocessor {
   void AddMacroDefinitions(const std::vector<std::string> &macro_definitions);
 
   std::string Cpp(const std::string &input_file);
+  // 直接从 clang 的预处理器获取记号, 不需要输出预处理后的代码再重新词法分析
+  std::vector<Token> Tokenize(const std::string &input_file);
+
+  void EmitPch(const std::string &header, const std::string &pch_file);
+  // 需要在 Cpp / Tokenize 之前调用
+  void IncludePch(const std::string &pch_file);
 
  private:
   void AddIncludePath(const std::string &path, bool is_system);
+  void EnterMainFile(const std::string &input_file);
+  Token ToToken(const clang::Token &tok);
+  Location ToLocation(clang::SourceLocation loc);
+  // 在记号全部得到之后, 把 #line 加入文件表
+  void AddLineMarkers();
+  std::string MacroToString(const clang::IdentifierInfo *name,
+                            const clang::MacroInfo &info);
+  // 影响预处理结果的选项的哈希值, 预编译头文件只能用于相同的选项
+  std::string GetOptionsHash() const;
 
   constexpr static std::size_t StrReserve{4096};
 
+  constexpr static std::size_t TokenReserve{1024};
+
   clang::Preprocessor *pp_;
   clang::HeaderSearch *header_search_;
+  std::unique_ptr<HeaderGuardSource> header_guards_;
+  // 按顺序记录的头文件搜索路径
+  std::string include_paths_;
+
+  Location loc_;
+  // clang 的 FileID -> 该文件在文件表中的位置
+  std::unordered_map<unsigned, Location> files_;
+  // 连续的记号大多来自同一个文件
+  clang::FileID last_file_id_;
+  Location last_file_loc_;
+
+  llvm::SmallString<64> spelling_;
+  // 记号引用其中的字符串, 需要在语法分析结束之前一直存在
+  llvm::BumpPtrAllocator allocator_;
+  llvm::StringSaver saver_{allocator_};
+
+  // 记号的位置指向其中保存的文件内容
+  std::optional<PchFile> pch_;
+
+  inline static KeywordsDictionary Keywords;
 };
 
 }  // namespace kcc
@@ -54,7 +54,7 @@ class DebugInfo {
   llvm::DICompileUnit *cu_;
   llvm::DIFile *file_;
   // 类似与 IRBuilder
-  llvm::DIBuilder builder_{*Module};
+  llvm::DIBuilder builder_{Module()};
 
   std::vector<llvm::DIScope *> lexical_blocks_;
 
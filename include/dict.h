@@ -4,21 +4,16 @@
 
 #pragma once
 
-#include <string>
 #include <string_view>
-#include <unordered_map>
 
 #include "token.h"
 
 namespace kcc {
 
+// 关键字表是编译期生成的完美哈希表, 查找时不分配内存
 class KeywordsDictionary {
  public:
-  KeywordsDictionary();
-  Tag Find(const std::string &name) const;
-
- private:
-  std::unordered_map<std::string_view, Tag> keywords_;
+  Tag Find(std::string_view name) const;
 };
 
 }  // namespace kcc
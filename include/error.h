@@ -5,9 +5,11 @@
 #pragma once
 
 #include <cstdlib>
+#include <functional>
 #include <string>
 #include <string_view>
-#include <utility>
+#include <tuple>
+#include <type_traits>
 #include <vector>
 
 #include <fmt/color.h>
@@ -19,11 +21,28 @@
 
 namespace kcc {
 
-inline std::vector<std::pair<std::string, std::string>> WarningStrings;
+// 警告在 PrintWarnings 时才格式化 (格式化消息, 计算行号, 读取行内容),
+// 此时源代码必须还没有释放
+struct PendingWarning {
+  // 可能无效, 此时只输出消息
+  Location loc;
+  std::function<std::string()> format;
+};
+
+// 编译上下文中的错误抛出此异常, 只终止当前的翻译单元
+// 错误信息在抛出之前已经输出
+struct CompilationError {};
+
+// 在编译上下文中抛出 CompilationError, 否则直接退出进程
+// 其他线程可能仍在编译, 因此不执行静态对象的析构函数
+[[noreturn]] void ExitFailure();
 
 [[noreturn]] void Error(Tag expect, const Token &actual);
 [[noreturn]] void Error(const UnaryOpExpr *unary, std::string_view msg);
 [[noreturn]] void Error(const BinaryOpExpr *binary, std::string_view msg);
+// 警告属于当前的编译上下文, 不在编译上下文中时属于驱动程序
+void AddWarning(PendingWarning warning);
+// 输出并清空当前编译上下文 (或驱动程序) 的警告, 相同的警告只输出一次
 void PrintWarnings();
 
 template <typename... Args>
@@ -33,7 +52,7 @@ template <typename... Args>
   fmt::print("\n");
 
   PrintWarnings();
-  std::exit(EXIT_FAILURE);
+  ExitFailure();
 }
 
 template <typename... Args>
@@ -50,7 +69,7 @@ template <typename... Args>
              loc.GetPositionArrow());
 
   PrintWarnings();
-  std::exit(EXIT_FAILURE);
+  ExitFailure();
 }
 
 template <typename... Args>
@@ -65,27 +84,34 @@ template <typename... Args>
   Error(expr->GetLoc(), format_str, args...);
 }
 
-template <typename... Args>
-void Warning(std::string_view format_str, const Args &...args) {
-  std::string str{"warning: "};
-
-  str += fmt::format(format_str, args...);
-  str += '\n';
-
-  WarningStrings.push_back({str, ""});
+// 参数在 PrintWarnings 时才使用, 字符串 (如 std::strerror 的返回值)
+// 需要复制一份, 其他参数按值保存
+template <typename T>
+auto SaveWarningArg(const T &arg) {
+  if constexpr (std::is_convertible_v<const T &, std::string_view>) {
+    return std::string{std::string_view{arg}};
+  } else {
+    return arg;
+  }
 }
 
+// 格式字符串总是字面量, 不需要复制
 template <typename... Args>
 void Warning(const Location &loc, std::string_view format_str,
              const Args &...args) {
-  std::string str;
-
-  str += fmt::format(FMT_STRING("{}: warning: "), loc.ToLocStr());
-  str += fmt::format(format_str, args...);
-  str += '\n';
-  str += loc.GetLineContent();
+  AddWarning(
+      {loc, [format_str, saved = std::tuple{SaveWarningArg(args)...}] {
+         return std::apply(
+             [format_str](const auto &...args) {
+               return fmt::format(format_str, args...);
+             },
+             saved);
+       }});
+}
 
-  WarningStrings.push_back({str, loc.GetPositionArrow()});
+template <typename... Args>
+void Warning(std::string_view format_str, const Args &...args) {
+  Warning(Location{}, format_str, args...);
 }
 
 template <typename... Args>
@@ -0,0 +1,57 @@
+//
+// Created by kaiser on 2026/10/16.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include <clang/Lex/HeaderSearch.h>
+#include <clang/Lex/Preprocessor.h>
+#include <llvm/ADT/IntrusiveRefCntPtr.h>
+#include <llvm/Support/VirtualFileSystem.h>
+
+namespace kcc {
+
+// 同一进程中所有翻译单元共享的头文件缓存
+// 缓存 stat 的结果 (包括不存在的路径, 头文件搜索时大部分查找都会失败)
+// 以及头文件的内容, 重复包含的头文件只需要一次哈希表查找
+llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> GetHeaderCache();
+
+// 翻译单元结束时记录检测到的 include guard
+void SaveHeaderGuards(const clang::HeaderSearch &header_search);
+
+// 在新的翻译单元中恢复 include guard, guard 宏已经定义时
+// 不需要再打开该头文件. 头文件第一次被查找时 clang 才会询问它,
+// 因此不需要为翻译单元没有用到的头文件调用 stat
+class HeaderGuardSource : public clang::ExternalHeaderFileInfoSource {
+ public:
+  explicit HeaderGuardSource(clang::Preprocessor &preprocessor);
+
+  clang::HeaderFileInfo GetHeaderFileInfo(
+      const clang::FileEntry *file) override;
+
+ private:
+  clang::Preprocessor &preprocessor_;
+};
+
+struct CachedHeader {
+  std::string name;
+  std::uint64_t size;
+  std::time_t mtime;
+  // 没有检测到 include guard 时为空
+  std::string guard;
+};
+
+// 编译服务器使用: 子进程编译结束后导出自己读取过的头文件 (只包括绝对路径,
+// 不包括从父进程继承的), 父进程预先读入它们, 之后 fork 出的子进程直接继承缓存
+std::vector<CachedHeader> GetCachedHeaders();
+
+void PreloadHeader(const CachedHeader &header);
+
+void PrintHeaderCacheStatistics();
+
+}  // namespace kcc
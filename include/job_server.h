@@ -0,0 +1,46 @@
+//
+// Created by kaiser on 2026/10/16.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace kcc {
+
+// GNU make jobserver 的客户端
+// 在 make -j 中调用时, 每编译一个翻译单元都需要先获取一个令牌,
+// 使并行度不超过用户给出的 -j
+class JobServer {
+ public:
+  // 从环境变量 MAKEFLAGS 中解析 --jobserver-auth
+  JobServer();
+  ~JobServer();
+
+  JobServer(const JobServer &) = delete;
+  JobServer &operator=(const JobServer &) = delete;
+
+  bool IsValid() const;
+
+  // 阻塞直到获取一个令牌
+  void Acquire();
+  void Release();
+
+ private:
+  void Parse(const std::string &auth);
+
+  std::int32_t read_fd_{-1};
+  std::int32_t write_fd_{-1};
+  bool is_fifo_{false};
+
+  std::mutex mutex_;
+  // 每个 make 的子进程都隐含地持有一个令牌
+  bool implicit_token_used_{false};
+  // 从 make 读到的令牌, 释放时原样写回
+  std::vector<char> tokens_;
+};
+
+}  // namespace kcc
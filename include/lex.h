@@ -7,6 +7,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -17,14 +18,25 @@
 
 namespace kcc {
 
+// 不拥有源代码, 记号的字符串直接引用源代码, 源代码必须比记号存在得更久
+// 源代码需要以空字符结尾
 class Scanner {
  public:
-  explicit Scanner(std::string preprocessed_code);
-  // for parser
-  Scanner(std::string code, const Location &loc);
+  explicit Scanner(std::string_view code);
+  // loc 为 code 开头的位置, 预处理后的代码需要先加入文件表
+  Scanner(std::string_view code, const Location &loc);
 
   std::vector<Token> Tokenize();
 
+  // 分离后可以在其他线程中扫描, 不访问文件表和符号表 (都属于编译上下文)
+  // 标识符只保存拼写, 需要文件表或符号表的记号 (行标记之后的记号,
+  // 含有通用字符名的标识符, 有错误的记号) tag 为 kNone, 只有位置,
+  // 由编译该翻译单元的线程调用 Rescan 从该位置重新扫描
+  void Detach();
+  // 扫描到结尾之后返回的都是 kEof
+  const Token &ScanDetached();
+  const Token &Rescan(const Location &loc);
+
   std::string HandleIdentifier();
   std::pair<std::int32_t, Encoding> HandleCharacter();
   std::pair<std::string, Encoding> HandleStringLiteral(bool handle_escape);
@@ -32,14 +44,27 @@ class Scanner {
  private:
   bool HasNext();
   std::int32_t Peek();
-  std::int32_t Next(bool push = true);
+  std::int32_t Next();
   void PutBack();
+  void Skip(std::size_t count);
+  std::string_view Rest() const;
   bool Test(std::int32_t c);
   bool Try(std::int32_t c);
   bool IsUCN(std::int32_t ch);
 
+  // 分离时不能输出诊断信息, 交给 Rescan 报告
+  struct Deferred {};
+  template <typename... Args>
+  [[noreturn]] void Error(const Location &loc, std::string_view format_str,
+                          const Args &...args);
+  template <typename... Args>
+  void Warning(const Location &loc, std::string_view format_str,
+               const Args &...args);
+  void Defer();
+
   const Token &MakeToken(Tag tag);
   void MarkLocation();
+  Location GetLoc() const;
 
   const Token &Scan();
 
@@ -57,13 +82,19 @@ class Scanner {
   std::int32_t HandleOctEscape(std::int32_t ch);
   std::int32_t HandleUCN(std::int32_t length);
 
-  std::string source_;
-  std::string::size_type index_{};
+  std::string_view source_;
+  std::string_view::size_type index_{};
+  // 当前记号的起始位置
+  std::string_view::size_type begin_{};
 
+  // source_ 开头的位置
   Location loc_;
 
   Token token_;
-  std::string buffer_;
+
+  bool detached_{};
+  // 需要重新扫描的位置
+  Location deferred_;
 
   constexpr static std::size_t TokenReserve{1024};
 
@@ -0,0 +1,28 @@
+//
+// Created by kaiser on 2026/10/16.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace kcc {
+
+// 词法分析的快速路径, 一次处理 16 (SSE2) 或 32 (AVX2) 个字节,
+// 不支持时使用逐字节的实现
+// 下面的函数都返回 str 开头满足条件的字节数
+
+// 空白字符
+std::size_t SpanSpace(std::string_view str);
+
+// [A-Za-z0-9_$] 以及 0x80 ~ 0xfd (UTF-8 编码的非 ascii 字符)
+std::size_t SpanIdentifier(std::string_view str);
+
+// [0-9]
+std::size_t SpanDigit(std::string_view str);
+
+// 不包含转义, 换行以及空字符的字符串或字符常量内容
+std::size_t SpanQuoted(std::string_view str, char quote);
+
+}  // namespace kcc
@@ -20,24 +20,15 @@
 #include <llvm/Target/TargetMachine.h>
 
 #include "ast.h"
+#include "context.h"
 
 namespace kcc {
 
-// 拥有许多 LLVM 核心数据结构, 如类型和常量值表
-inline llvm::LLVMContext Context;
-// 一个辅助对象, 跟踪当前位置并且可以插入 LLVM 指令
-inline llvm::IRBuilder<> Builder{Context};
-// 包含函数和全局变量, 它拥有生成的所有 IR 的内存
-inline std::unique_ptr<llvm::Module> Module;
-
-inline clang::TargetInfo *TargetInfo;
-
-inline std::unique_ptr<llvm::TargetMachine> TargetMachine;
-
-inline clang::CompilerInstance Ci;
-
+// 初始化所有编译上下文共享的目标平台信息, 只需调用一次
 void InitLLVM();
 
+std::unique_ptr<llvm::TargetMachine> CreateTargetMachine();
+
 std::string LLVMTypeToStr(llvm::Type *type);
 
 std::string LLVMConstantToStr(llvm::Constant *constant);
@@ -7,18 +7,26 @@
 #include <cstddef>
 #include <cstdint>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "symbol.h"
 
 namespace kcc {
 
+// 源代码中的位置, 只保存在文件表中的偏移
+// 文件名, 行号, 列号以及行内容在需要时 (如输出诊断信息) 才计算
 class Location {
  public:
-  void SetFileName(const std::string &file_name);
-  void SetContent(const char *content);
-  void NextRow(std::size_t line_begin);
-  void NextColumn();
-  void PrevRow();
-  void PrevColumn();
-  void SetRow(std::int32_t row);
+  Location() = default;
+  explicit Location(std::uint32_t offset);
+
+  bool IsValid() const;
+  std::uint32_t GetOffset() const;
+  // 同一文件中之后第 offset 个字节的位置
+  Location GetLocWithOffset(std::size_t offset) const;
+
   std::string GetFileName() const;
 
   std::string ToLocStr() const;
@@ -29,15 +37,40 @@ class Location {
   std::int32_t GetColumn() const;
 
  private:
-  std::string file_name_;
-  const char *content_;
+  // 为 0 时表示无效的位置
+  std::uint32_t offset_{};
+};
 
-  std::size_t line_begin_{};
-  std::int32_t row_{1};
-  std::int32_t column_{1};
+// 行标记 (如 # 1 "file" 或 #line) 之后的行使用新的文件名和行号
+struct LineMarker {
+  // 在文件内容中的偏移
+  std::uint32_t offset;
+  Symbol file_name;
+  // offset 所在行的行号
+  std::int32_t row;
+};
 
-  std::size_t line_begin_backup_{};
-  std::int32_t column_backup_{};
+// 文件表中的一个源文件 (或其他源代码缓冲区)
+struct SourceFile {
+  // 在文件表中的起始偏移, 文件结尾也占据一个位置
+  std::uint32_t begin;
+  std::string_view content;
+  // 按偏移排序, 第一个总是在文件开头
+  std::vector<LineMarker> markers;
+  // 每行开头的偏移, 第一次查询行号, 列号或行内容时建立
+  std::vector<std::uint32_t> line_begins;
 };
 
+// 每个翻译单元有一个文件表, 所有源代码依次映射到同一个 32 位的偏移空间中
+// 文件内容不归文件表所有, 必须比引用它的 Location 存在得更久
+
+// 返回文件开头的位置
+Location AddSourceFile(std::string_view file_name, std::string_view content);
+// loc 所在行的行号为 row, 之后的行使用 file_name
+void AddLineMarker(Location loc, std::string_view file_name, std::int32_t row);
+
+// 位置所在的文件在文件表中的下标, 以及在该文件中的偏移
+std::pair<std::size_t, std::uint32_t> DecomposeLocation(Location loc);
+const SourceFile &GetSourceFile(std::size_t index);
+
 }  // namespace kcc
@@ -0,0 +1,13 @@
+//
+// Created by kaiser on 2026/10/16.
+//
+
+#pragma once
+
+namespace kcc {
+
+// 将 ObjFile 中所有 bitcode 目标文件合并为一个模块, 统一优化并生成
+// 一个目标文件, 用它替换这些 bitcode 目标文件
+void LinkTimeOptimization();
+
+}  // namespace kcc
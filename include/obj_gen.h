@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 
 #include <llvm/Target/TargetMachine.h>
@@ -14,4 +15,12 @@ void ObjGen(
     const std::string &obj_file,
     llvm::CodeGenFileType file_type = llvm::CodeGenFileType::CGFT_ObjectFile);
 
+// 将模块分为 partitions 个分区, 在多个线程中分别生成代码,
+// 最后合并为一个目标文件
+void ParallelObjGen(const std::string &obj_file, std::uint32_t partitions);
+
+// -flto 时目标文件中保存的是 bitcode
+// -flto=thin 时同时写入 ThinLTO 所需的模块摘要
+void BitcodeGen(const std::string &obj_file, bool with_summary = false);
+
 }  // namespace kcc
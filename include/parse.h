@@ -20,6 +20,7 @@
 #include "location.h"
 #include "scope.h"
 #include "token.h"
+#include "token_stream.h"
 #include "type.h"
 
 namespace kcc {
@@ -27,6 +28,8 @@ namespace kcc {
 class Parser {
  public:
   explicit Parser(std::vector<Token> tokens);
+  // 边读取边分析, 与词法分析同时进行
+  explicit Parser(TokenStream &stream);
   TranslationUnit *ParseTranslationUnit();
 
  private:
@@ -34,6 +37,7 @@ class Parser {
   const Token &Peek();
   const Token &Next();
   void PutBack();
+  void DiscardTokens();
   bool Test(Tag tag);
   bool Try(Tag tag);
   const Token &Expect(Tag tag);
@@ -47,8 +51,8 @@ class Parser {
   bool IsTypeName(const Token &tok);
   bool IsDecl(const Token &tok);
   std::int64_t ParseInt64Constant();
-  LabelStmt *FindLabel(const std::string &name) const;
-  static auto GetStructDesignator(Type *type, const std::string &name)
+  LabelStmt *FindLabel(Symbol name) const;
+  static auto GetStructDesignator(Type *type, Symbol name)
       -> decltype(std::begin(type->StructGetMembers()));
   Declaration *MakeDeclaration(const Token &token, QualType type,
                                std::uint32_t storage_class_spec,
@@ -66,16 +70,8 @@ class Parser {
   Expr *ParseExpr();
   Expr *ParseAssignExpr();
   Expr *ParseConditionExpr();
-  Expr *ParseLogicalOrExpr();
-  Expr *ParseLogicalAndExpr();
-  Expr *ParseInclusiveOrExpr();
-  Expr *ParseExclusiveOrExpr();
-  Expr *ParseAndExpr();
-  Expr *ParseEqualityExpr();
-  Expr *ParseRelationExpr();
-  Expr *ParseShiftExpr();
-  Expr *ParseAdditiveExpr();
-  Expr *ParseMultiplicativeExpr();
+  // 逻辑或到乘除的所有二元运算符, 1 为逻辑或的优先级
+  Expr *ParseBinaryExpr(std::int32_t min_prec = 1);
   Expr *ParseCastExpr();
   Expr *ParseUnaryExpr();
   Expr *ParseSizeof();
@@ -206,11 +202,13 @@ class Parser {
 
   std::vector<Token> tokens_;
   decltype(tokens_)::size_type index_{};
+  // 不为空时 tokens_ 只保存当前外部声明的记号
+  TokenStream *stream_{};
 
   FuncDef *func_def_{};
   Scope *scope_{Scope::Get(nullptr, kFile)};
 
-  std::unordered_map<std::string, LabelStmt *> labels_;
+  std::unordered_map<Symbol, LabelStmt *> labels_;
   std::vector<GotoStmt *> gotos_;
 
   // 用于将块作用与的复合字面量加入块中
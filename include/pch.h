@@ -0,0 +1,70 @@
+//
+// Created by kaiser on 2026/10/16.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "token.h"
+
+namespace kcc {
+
+// 预编译头文件中保存的记号, 位置用文件的下标和在文件中的偏移表示
+struct PchToken {
+  Tag tag;
+  std::string str;
+  // 在 PchFile::contents 中的下标
+  std::uint32_t file;
+  std::uint32_t offset;
+};
+
+// 文件表中的行标记, 每个文件的第一个行标记在文件开头
+struct PchLineMarker {
+  // 在 PchFile::contents 中的下标
+  std::uint32_t file;
+  std::uint32_t offset;
+  // 在 PchFile::names 中的下标
+  std::uint32_t name;
+  std::int32_t row;
+};
+
+// 生成预编译头文件时读取的文件
+struct PchDependency {
+  std::string name;
+  std::uint64_t size;
+  std::int64_t time;
+};
+
+// 预编译头文件, 实际上是头文件预处理结果的缓存
+// 保存头文件预处理结束时的宏定义 (包括 #undef) 以及预处理后的记号序列,
+// 使用它的翻译单元不需要再预处理和词法分析该头文件, 但仍然要语法分析它.
+// 声明和作用域不保存: AST, 类型和作用域都分配在每个翻译单元的 arena 中,
+// 并引用该翻译单元的 llvm::Module, 而对头文件来说预处理 (打开并扫描大量
+// 系统头文件) 远比语法分析昂贵
+struct PchFile {
+  void Write(const std::string &file_name) const;
+  void Read(const std::string &file_name);
+
+  // 头文件或它包含的文件修改后, 或者影响预处理的选项改变后预编译头文件失效
+  bool IsUpToDate(const std::string &options) const;
+
+  std::vector<Token> GetTokens() const;
+
+  std::string header;
+  std::vector<PchDependency> dependencies;
+  // 影响预处理的选项 (包括预定义的宏) 的哈希值
+  std::string options;
+
+  std::vector<std::string> names;
+  std::vector<std::string> contents;
+  // 按文件和偏移排序
+  std::vector<PchLineMarker> markers;
+  // #define 形式的宏定义
+  std::string macros;
+  std::vector<PchToken> tokens;
+};
+
+}  // namespace kcc
@@ -4,10 +4,14 @@
 
 #pragma once
 
-#include <string>
+#include <cstddef>
 #include <unordered_map>
+#include <vector>
+
+#include <llvm/ADT/SmallVector.h>
 
 #include "ast.h"
+#include "symbol.h"
 #include "token.h"
 
 namespace kcc {
@@ -22,7 +26,7 @@ enum ScopeType { kBlock, kFile, kFunc, kFuncProto };
 // 标号命名空间:所有声明为标号的标识符
 // 标签名:所有声明为 struct union enum 类型名称的标识符
 // 成员名:所有声明为至少为一个 struct 或 union 成员的标识符
-// 每个结构体和联合体引入它自己的这种命名空间
+// 每个结构体和联合体引入它自己的这种命名空间, 保存在 StructType 中
 // 所有其他标识符, 称之为通常标识符以别于(1-3)
 
 // 在查找点, 根据使用方式确定标识符所属的命名空间
@@ -35,39 +39,59 @@ class Scope {
  public:
   static Scope *Get(Scope *parent, enum ScopeType type);
 
-  auto begin() { return std::begin(usual_); }
-  auto end() { return std::end(usual_); }
-  auto begin() const { return std::begin(usual_); }
-  auto end() const { return std::end(usual_); }
+  // 块作用域或函数原型作用域结束时调用, 移除其中的声明
+  // 作用域严格嵌套, 只能结束最内层的作用域
+  void Exit();
 
   void InsertTag(IdentifierExpr *ident);
   void InsertUsual(IdentifierExpr *ident);
-  void InsertTag(const std::string &name, IdentifierExpr *ident);
-  void InsertUsual(const std::string &name, IdentifierExpr *ident);
+  void InsertTag(Symbol name, IdentifierExpr *ident);
+  void InsertUsual(Symbol name, IdentifierExpr *ident);
 
-  IdentifierExpr *FindTag(const std::string &name);
-  IdentifierExpr *FindUsual(const std::string &name);
-  IdentifierExpr *FindTagInCurrScope(const std::string &name);
-  IdentifierExpr *FindUsualInCurrScope(const std::string &name);
+  // 除了 InCurrScope 外只能在最内层的作用域中查找
+  IdentifierExpr *FindTag(Symbol name);
+  IdentifierExpr *FindUsual(Symbol name);
+  IdentifierExpr *FindTagInCurrScope(Symbol name);
+  IdentifierExpr *FindUsualInCurrScope(Symbol name);
 
   IdentifierExpr *FindUsual(const Token &tok);
 
-  std::unordered_map<std::string, IdentifierExpr *> AllTagInCurrScope() const;
   Scope *GetParent();
 
   bool IsFileScope() const;
   bool IsBlockScope() const;
 
  private:
+  struct Binding {
+    Scope *scope;
+    IdentifierExpr *ident;
+  };
+
+  // 同一个名字的所有可见声明, 栈顶为最内层的声明
+  using BindingStack = llvm::SmallVector<Binding, 1>;
+  using Bindings = std::unordered_map<Symbol, BindingStack>;
+
+  // 一个翻译单元中的所有作用域共享一个符号表, 查找只需要一次哈希,
+  // 与作用域嵌套的深度无关
+  struct SymbolTable {
+    Bindings tags;
+    Bindings usual;
+    // 按插入的顺序记录新的绑定, 结束作用域时弹出
+    std::vector<BindingStack *> log;
+  };
+
   Scope(Scope *parent, enum ScopeType type);
 
+  void Insert(Bindings &bindings, Symbol name, IdentifierExpr *ident);
+  IdentifierExpr *Find(Bindings &bindings, Symbol name);
+  IdentifierExpr *FindInCurrScope(Bindings &bindings, Symbol name);
+
   Scope *parent_;
   enum ScopeType type_;
 
-  // struct / union / enum 的名字
-  std::unordered_map<std::string, IdentifierExpr *> tags_;
-  // 函数 / 对象 / typedef名 / 枚举常量
-  std::unordered_map<std::string, IdentifierExpr *> usual_;
+  SymbolTable *table_;
+  // 进入作用域时 log 的大小
+  std::size_t log_begin_;
 };
 
 }  // namespace kcc
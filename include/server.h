@@ -0,0 +1,24 @@
+//
+// Created by kaiser on 2026/10/16.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+namespace kcc {
+
+// 若环境变量 KCC_SERVER 非空且不为 0, 并且编译服务器正在运行,
+// 则将命令行转发给它, 返回编译的退出码, 否则返回 std::nullopt,
+// 由当前进程自己编译
+// 套接字的路径由 KCC_SERVER_SOCKET 指定, 默认为 $XDG_RUNTIME_DIR/kcc.sock
+// 或 /tmp/kcc-<uid>/kcc.sock
+std::optional<std::int32_t> RunClient(int argc, char *argv[]);
+
+// 常驻的编译服务器, LLVM 只需初始化一次
+// 每个请求都在 fork 出的子进程中以客户端的工作目录和标准输入输出调用 run
+// 子进程读取过的头文件由服务器保存, 之后的请求直接继承
+[[noreturn]] void RunServer(std::int32_t (*run)());
+
+}  // namespace kcc
@@ -0,0 +1,46 @@
+//
+// Created by kaiser on 2026/10/16.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace kcc {
+
+// 驻留的标识符, 同一个编译上下文中相同的名字只保存一份,
+// 比较和哈希只需要比较指针
+class Symbol {
+ public:
+  Symbol() = default;
+  explicit Symbol(std::string_view name);
+
+  const std::string &GetName() const;
+  bool Empty() const;
+
+  // 用于保存在 clang::IdentifierInfo 中, 之后不需要再查找驻留表
+  void *GetOpaqueValue() const;
+  static Symbol GetFromOpaqueValue(void *value);
+
+  friend bool operator==(const Symbol &lhs, const Symbol &rhs) = default;
+
+ private:
+  // 空的名字为 nullptr
+  const std::string *name_{};
+};
+
+}  // namespace kcc
+
+namespace std {
+
+template <>
+struct hash<kcc::Symbol> {
+  std::size_t operator()(const kcc::Symbol &symbol) const noexcept {
+    return std::hash<void *>{}(symbol.GetOpaqueValue());
+  }
+};
+
+}  // namespace std
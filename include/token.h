@@ -4,13 +4,16 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 
 #include "location.h"
+#include "symbol.h"
 
 namespace kcc {
 
-enum class Tag {
+enum class Tag : std::uint8_t {
   kAuto,
   kBreak,
   kCase,
@@ -143,9 +146,16 @@ class Token {
   void SetTag(Tag tag);
   Tag GetTag() const;
 
-  std::string GetStr() const;
-  void SetStr(const std::string &str);
-  std::string GetIdentifier() const;
+  // 引用源代码缓冲区, 不拥有其内存
+  // 标识符返回其名字 (通用字符名已经转换)
+  std::string_view GetStr() const;
+  void SetStr(std::string_view str);
+  // 分离的 Scanner 扫描到的标识符在 SetSymbol 之前保存其拼写
+  std::string_view GetSpelling() const;
+
+  // 只有标识符有, 需要先设置 tag
+  Symbol GetSymbol() const;
+  void SetSymbol(Symbol symbol);
 
   Location GetLoc() const;
   void SetLoc(const Location &loc);
@@ -164,9 +174,15 @@ class Token {
   bool IsDeclSpec() const;
 
  private:
-  Tag tag_{Tag::kNone};
-  std::string str_;
+  constexpr static std::uint32_t MaxSize{(1U << 24) - 1};
+
+  // 标识符为 Symbol (SetSymbol 之前也可能指向源代码), 其他记号指向源代码
+  const void *data_{};
   Location loc_;
+  std::uint32_t size_ : 24 {};
+  Tag tag_ : 8 {Tag::kNone};
 };
 
+static_assert(sizeof(Token) == 16);
+
 }  // namespace kcc
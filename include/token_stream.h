@@ -0,0 +1,74 @@
+//
+// Created by kaiser on 2026/10/16.
+//
+
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "lex.h"
+#include "location.h"
+#include "token.h"
+
+namespace kcc {
+
+// 词法分析与语法分析流水线化
+// 词法分析在单独的线程中进行, 通过单生产者单消费者的无锁环形缓冲区把记号
+// 交给语法分析线程, 同时存在的记号数由缓冲区的大小而不是源代码的大小决定
+// 文件表和符号表属于编译上下文, 只由语法分析线程访问, 见 Scanner::Detach
+class TokenStream {
+ public:
+  // code 需要先加入文件表, loc 为其开头的位置
+  TokenStream(std::string_view code, const Location &loc);
+  ~TokenStream();
+
+  TokenStream(const TokenStream &) = delete;
+  TokenStream &operator=(const TokenStream &) = delete;
+
+  // 语法分析线程调用, 把新的记号追加到 tokens 之后, 没有时等待
+  // 读到 kEof 之后不能再调用
+  void Read(std::vector<Token> &tokens);
+
+ private:
+  // 词法分析线程
+  void Run();
+  void Write(const Token &token);
+  void Publish();
+
+  // 语法分析线程
+  std::uint32_t Acquire();
+  void Release();
+
+  constexpr static std::uint32_t Capacity{4096};
+  // 每写入这么多记号才通知一次语法分析线程
+  constexpr static std::uint32_t BatchSize{64};
+  static_assert(std::has_single_bit(Capacity) && Capacity % BatchSize == 0);
+
+  Scanner scanner_;
+  // 语法分析线程用于重新扫描 kNone
+  Scanner rescanner_;
+
+  std::unique_ptr<Token[]> buffer_{std::make_unique<Token[]>(Capacity)};
+
+  // 读取和写入的记号总数, 对 Capacity 取模即为下标
+  alignas(64) std::atomic<std::uint32_t> head_{};
+  alignas(64) std::atomic<std::uint32_t> tail_{};
+
+  // 只由词法分析线程访问
+  alignas(64) std::uint32_t write_{};
+  std::uint32_t head_cache_{};
+
+  // 只由语法分析线程访问
+  alignas(64) std::uint32_t read_{};
+  bool eof_{};
+
+  std::thread thread_;
+};
+
+}  // namespace kcc
@@ -4,14 +4,18 @@
 
 #pragma once
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <llvm/IR/Type.h>
 
+#include "symbol.h"
+
 namespace kcc {
 
 enum TypeSpec {
@@ -67,6 +71,36 @@ enum TypeSpecCompatibility {
   kCompDouble = kLong
 };
 
+// 用于 llvm::isa / cast / dyn_cast
+enum class TypeKind : std::uint8_t {
+  kVoid,
+  kArithmetic,
+  kPointer,
+  kArray,
+  kStruct,
+  kFunction
+};
+
+// 常用的类型分类, 构造时计算, 谓词只需要检查对应的位
+enum TypeCategory : std::uint16_t {
+  kVoidTy = 0x1,
+  kBoolTy = 0x2,
+  kCharacterTy = 0x4,
+  kIntegerTy = 0x8,
+  kRealFloatPointTy = 0x10,
+  // bool 也是无符号的
+  kUnsignedTy = 0x20,
+  kPointerTy = 0x40,
+  kArrayTy = 0x80,
+  kStructTy = 0x100,
+  kUnionTy = 0x200,
+  kFunctionTy = 0x400,
+
+  kArithmeticTy = kBoolTy | kIntegerTy | kRealFloatPointTy,
+  kScalarTy = kArithmeticTy | kPointerTy,
+  kAggregateTy = kArrayTy | kStructTy | kUnionTy
+};
+
 class Type;
 class VoidType;
 class ArithmeticType;
@@ -75,7 +109,6 @@ class ArrayType;
 class StructType;
 class FunctionType;
 class ObjectExpr;
-class Scope;
 
 class QualType {
   friend bool operator==(QualType lhs, QualType rhs);
@@ -111,8 +144,6 @@ class Type {
   // 数组和函数隐式转换为指针
   static QualType MayCast(QualType type);
 
-  virtual ~Type() = default;
-
   // 字节数
   virtual std::int32_t GetWidth() const = 0;
   virtual std::int32_t GetAlign() const = 0;
@@ -124,6 +155,9 @@ class Type {
   std::string ToString() const;
   llvm::Type *GetLLVMType() const;
 
+  TypeKind GetKind() const;
+
+  // 类型不符时返回 nullptr
   VoidType *ToVoidType();
   ArithmeticType *ToArithmeticType();
   PointerType *ToPointerType();
@@ -188,9 +222,9 @@ class Type {
   std::vector<ObjectExpr *> &StructGetMembers();
   const std::vector<ObjectExpr *> &StructGetMembers() const;
   void StructSetMembers(std::vector<ObjectExpr *> &members);
-  ObjectExpr *StructGetMember(const std::string &name) const;
+  ObjectExpr *StructGetMember(Symbol name) const;
   QualType StructGetMemberType(std::int32_t i) const;
-  Scope *StructGetScope();
+  const std::unordered_map<Symbol, ObjectExpr *> &StructGetMemberMap() const;
   void StructAddMember(ObjectExpr *member);
   void StructMergeAnonymous(ObjectExpr *anonymous);
   std::int32_t StructGetOffset() const;
@@ -206,11 +240,18 @@ class Type {
   const std::string &FuncGetName() const;
 
  protected:
-  explicit Type(bool complete);
+  Type(TypeKind kind, std::uint16_t category, bool complete);
+  // 在 AstArena 中分配, 不会通过基类指针删除
+  ~Type() = default;
 
   llvm::Type *llvm_type_{};
 
  private:
+  bool Is(std::uint16_t category) const;
+
+  TypeKind kind_;
+  // TypeCategory 的组合
+  std::uint16_t category_;
   mutable bool complete_{false};
 };
 
@@ -218,6 +259,8 @@ class VoidType : public Type {
  public:
   static VoidType *Get();
 
+  static bool classof(const Type *type);
+
   virtual std::int32_t GetWidth() const override;
   virtual std::int32_t GetAlign() const override;
   virtual bool Compatible(const Type *other) const override;
@@ -236,6 +279,8 @@ class ArithmeticType : public Type {
   static Type *IntegerPromote(Type *type);
   static Type *MaxType(Type *lhs, Type *rhs);
 
+  static bool classof(const Type *type);
+
   virtual std::int32_t GetWidth() const override;
   virtual std::int32_t GetAlign() const override;
   virtual bool Compatible(const Type *other) const override;
@@ -248,6 +293,7 @@ class ArithmeticType : public Type {
   std::uint64_t MaxIntegerValue() const;
 
   static std::uint32_t DealWithTypeSpec(std::uint32_t type_spec);
+  static std::uint16_t Category(std::uint32_t type_spec);
 
   std::uint32_t type_spec_{};
 };
@@ -256,6 +302,8 @@ class PointerType : public Type {
  public:
   static PointerType *Get(QualType element_type);
 
+  static bool classof(const Type *type);
+
   virtual std::int32_t GetWidth() const override;
   virtual std::int32_t GetAlign() const override;
   virtual bool Compatible(const Type *other) const override;
@@ -274,6 +322,8 @@ class ArrayType : public Type {
   static ArrayType *Get(QualType contained_type,
                         std::optional<std::size_t> num_elements = {});
 
+  static bool classof(const Type *type);
+
   virtual std::int32_t GetWidth() const override;
   virtual std::int32_t GetAlign() const override;
   virtual bool Compatible(const Type *other) const override;
@@ -294,8 +344,9 @@ class StructType : public Type {
   friend class Type;
 
  public:
-  static StructType *Get(bool is_struct, const std::string &name,
-                         Scope *parent);
+  static StructType *Get(bool is_struct, const std::string &name);
+
+  static bool classof(const Type *type);
 
   virtual std::int32_t GetWidth() const override;
   virtual std::int32_t GetAlign() const override;
@@ -311,9 +362,9 @@ class StructType : public Type {
   std::vector<ObjectExpr *> &GetMembers();
   const std::vector<ObjectExpr *> &GetMembers() const;
   void SetMembers(std::vector<ObjectExpr *> &members);
-  ObjectExpr *GetMember(const std::string &name) const;
+  ObjectExpr *GetMember(Symbol name) const;
   QualType GetMemberType(std::int32_t i) const;
-  Scope *GetScope();
+  const std::unordered_map<Symbol, ObjectExpr *> &GetMemberMap() const;
   std::int32_t GetOffset() const;
 
   void AddMember(ObjectExpr *member);
@@ -325,7 +376,7 @@ class StructType : public Type {
   static std::int32_t MakeAlign(std::int32_t offset, std::int32_t align);
 
  private:
-  StructType(bool is_struct, const std::string &name, Scope *parent);
+  StructType(bool is_struct, const std::string &name);
 
   void AddLLVMType(Type *type);
   void AddBitFieldBeforeMember();
@@ -339,7 +390,8 @@ class StructType : public Type {
   bool is_struct_{};
   std::string name_;
   std::vector<ObjectExpr *> members_;
-  Scope *scope_{};
+  // 成员名字空间, 包括匿名 struct / union 中的成员
+  std::unordered_map<Symbol, ObjectExpr *> member_map_;
 
   std::int32_t offset_{};
   std::int32_t width_{};
@@ -359,6 +411,8 @@ class FunctionType : public Type {
                            std::vector<ObjectExpr *> params,
                            bool is_var_args = false);
 
+  static bool classof(const Type *type);
+
   virtual std::int32_t GetWidth() const override;
   virtual std::int32_t GetAlign() const override;
   virtual bool Compatible(const Type *other) const override;
@@ -387,4 +441,49 @@ class FunctionType : public Type {
   std::string name_;
 };
 
+// 指针和完整数组类型创建后不会再修改, 相同的类型只创建一次,
+// 比较时可以先比较指针
+// 函数类型保存了参数对象, 名字和是否已定义, 不能共享
+struct DerivedTypeKey {
+  bool operator==(const DerivedTypeKey &) const = default;
+
+  const Type *type;
+  std::uint32_t type_qual;
+  std::size_t num_elements;
+};
+
+struct DerivedTypeKeyHash {
+  std::size_t operator()(const DerivedTypeKey &key) const;
+};
+
+// 编译上下文中共享的类型, 在第一次使用时创建
+struct TypeTable {
+  // 内置的算术类型, 与 arithmetic_types 一一对应
+  constexpr static std::array<std::uint32_t, 14> ArithmeticTypeSpecs{
+      kBool,
+      kChar,
+      kChar | kUnsigned,
+      kShort,
+      kShort | kUnsigned,
+      kInt,
+      kInt | kUnsigned,
+      kLong,
+      kLong | kUnsigned,
+      kLongLong,
+      kLongLong | kUnsigned,
+      kFloat,
+      kDouble,
+      kDouble | kLong,
+  };
+
+  VoidType *void_type{};
+  std::array<ArithmeticType *, std::size(ArithmeticTypeSpecs)>
+      arithmetic_types{};
+
+  std::unordered_map<DerivedTypeKey, PointerType *, DerivedTypeKeyHash>
+      pointer_types;
+  std::unordered_map<DerivedTypeKey, ArrayType *, DerivedTypeKeyHash>
+      array_types;
+};
+
 }  // namespace kcc
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <string>
 #include <string_view>
@@ -17,6 +18,8 @@ enum class OptLevel { kO0, kO1, kO2, kO3 };
 
 enum class Langs { kC };
 
+enum class LtoKinds { kNone, kFull, kThin };
+
 enum class LangStds { kC89, kC99, kC11, kC17, kGnu89, kGnu99, kGnu11, kGnu17 };
 
 inline std::vector<std::string> ObjFile;
@@ -84,6 +87,63 @@ inline llvm::cl::opt<bool> OutputAssembly{
 inline llvm::cl::opt<bool> Timing{
     "t", llvm::cl::desc{"Print the amount of time"}, llvm::cl::cat{Category}};
 
+inline llvm::cl::opt<std::uint32_t> Jobs{
+    "j",
+    llvm::cl::desc{"Number of translation units to compile in parallel "
+                   "(default: number of cores)"},
+    llvm::cl::value_desc{"number"}, llvm::cl::init(0), llvm::cl::Prefix,
+    llvm::cl::cat{Category}};
+
+inline llvm::cl::opt<LtoKinds> FLto{
+    "flto",
+    llvm::cl::desc{"Emit bitcode objects and optimize the whole program at "
+                   "link time"},
+    llvm::cl::init(LtoKinds::kNone),
+    llvm::cl::ValueOptional,
+    llvm::cl::values(
+        clEnumValN(LtoKinds::kFull, "", "Full LTO (default)"),
+        clEnumValN(LtoKinds::kFull, "full", "Full LTO"),
+        clEnumValN(LtoKinds::kThin, "thin",
+                   "ThinLTO, optimize modules in parallel with summaries")),
+    llvm::cl::cat{Category}};
+
+inline llvm::cl::opt<std::uint32_t> ParallelCodegen{
+    "fparallel-codegen",
+    llvm::cl::desc{"Split each module into <number> partitions and generate "
+                   "code for them in parallel (default: 1)"},
+    llvm::cl::value_desc{"number"}, llvm::cl::init(1),
+    llvm::cl::cat{Category}};
+
+inline llvm::cl::opt<bool> FPipelineLex{
+    "fpipeline-lex",
+    llvm::cl::desc{"Lex preprocessed (.i) files on a separate thread while "
+                   "parsing them"},
+    llvm::cl::cat{Category}};
+
+inline llvm::cl::opt<bool> FCache{
+    "fcache", llvm::cl::desc{"Reuse object files from the compilation cache"},
+    llvm::cl::cat{Category}};
+
+inline llvm::cl::opt<std::string> CacheDir{
+    "cache-dir",
+    llvm::cl::desc{"Directory of the compilation cache (default: "
+                   "$KCC_CACHE_DIR or ~/.cache/kcc)"},
+    llvm::cl::value_desc{"directory"}, llvm::cl::cat{Category}};
+
+inline llvm::cl::opt<std::uint32_t> CacheSize{
+    "cache-size",
+    llvm::cl::desc{"Maximum size of the compilation cache in MiB (default: "
+                   "1024)"},
+    llvm::cl::value_desc{"MiB"}, llvm::cl::init(1024),
+    llvm::cl::cat{Category}};
+
+inline llvm::cl::opt<bool> Server{
+    "server",
+    llvm::cl::desc{"Run as a compile server listening on $KCC_SERVER_SOCKET "
+                   "(default: $XDG_RUNTIME_DIR/kcc.sock or "
+                   "/tmp/kcc-<uid>/kcc.sock)"},
+    llvm::cl::cat{Category}};
+
 inline llvm::cl::opt<bool> Shared{"shared",
                                   llvm::cl::desc{"Generate dynamic library"},
                                   llvm::cl::cat{Category}};
@@ -134,6 +194,16 @@ inline llvm::cl::opt<bool> FPic{
     "fPIC", llvm::cl::desc{"Emit position-independent code"},
     llvm::cl::cat{Category}};
 
+inline llvm::cl::opt<bool> EmitPch{
+    "emit-pch",
+    llvm::cl::desc{"Generate a precompiled header (the preprocessed tokens "
+                   "and macros of a header)"},
+    llvm::cl::cat{Category}};
+
+inline llvm::cl::opt<std::string> IncludePch{
+    "include-pch", llvm::cl::desc{"Include the precompiled header <file>"},
+    llvm::cl::value_desc{"file"}, llvm::cl::cat{Category}};
+
 inline llvm::cl::opt<bool> FPch{
     "fpch-preprocess",
     llvm::cl::desc{"Allows use of a precompiled header together with -E"},
@@ -156,12 +226,20 @@ void CommandLineCheck();
 
 std::string GetPath();
 
+using TimePoint = std::chrono::system_clock::time_point;
+
+TimePoint Now();
+
 void TimingStart();
 
 void TimingEnd(const std::string &str = "");
 
+void TimingEnd(const std::string &str, TimePoint start);
+
 void EnsureFileExists(const std::string &file_name);
 
+std::string CreateObjFile(const std::string &name);
+
 std::string GetObjFile(const std::string &name);
 
 std::string GetFileName(const std::string &name, std::string_view extension);
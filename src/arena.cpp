@@ -0,0 +1,44 @@
+//
+// Created by kaiser on 2026/10/16.
+//
+
+#include "arena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace kcc {
+
+Arena::~Arena() { Reset(); }
+
+void Arena::Reset() {
+  std::for_each(std::rbegin(destructors_), std::rend(destructors_),
+                [](const Destructor &item) { item.destroy(item.object); });
+  destructors_.clear();
+
+  slabs_.clear();
+  ptr_ = end_ = nullptr;
+}
+
+std::byte *Arena::AlignUp(std::byte *ptr, std::size_t align) {
+  auto value{reinterpret_cast<std::uintptr_t>(ptr)};
+  return reinterpret_cast<std::byte *>((value + align - 1) & ~(align - 1));
+}
+
+void *Arena::AllocateSlow(std::size_t size, std::size_t align) {
+  // 较大的分配单独使用一块, 不浪费当前块剩余的空间
+  if (size + align > SlabSize / 4) {
+    auto &slab{slabs_.emplace_back(new std::byte[size + align])};
+    return AlignUp(slab.get(), align);
+  }
+
+  auto &slab{slabs_.emplace_back(new std::byte[SlabSize])};
+  ptr_ = AlignUp(slab.get(), align);
+  end_ = slab.get() + SlabSize;
+
+  auto ptr{ptr_};
+  ptr_ += size;
+  return ptr;
+}
+
+}  // namespace kcc
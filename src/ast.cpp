@@ -8,9 +8,9 @@
 
 #include <magic_enum.hpp>
 
+#include "arena.h"
 #include "error.h"
 #include "llvm_common.h"
-#include "memory_pool.h"
 #include "visitor.h"
 
 namespace kcc {
@@ -107,7 +107,7 @@ Expr::Expr(QualType type) : type_{type} {}
  */
 UnaryOpExpr *UnaryOpExpr::Get(Tag tag, Expr *expr) {
   assert(expr != nullptr);
-  return new (UnaryOpExprPool.malloc()) UnaryOpExpr{tag, expr};
+  return new (AstArena().Allocate<UnaryOpExpr>()) UnaryOpExpr{tag, expr};
 }
 
 AstNodeType UnaryOpExpr::Kind() const { return AstNodeType::kUnaryOpExpr; }
@@ -226,7 +226,7 @@ void UnaryOpExpr::AddrOpCheck() {
  */
 TypeCastExpr *TypeCastExpr::Get(Expr *expr, QualType to) {
   assert(expr != nullptr);
-  return new (TypeCastExprPool.malloc()) TypeCastExpr{expr, to};
+  return new (AstArena().Allocate<TypeCastExpr>()) TypeCastExpr{expr, to};
 }
 
 AstNodeType TypeCastExpr::Kind() const { return AstNodeType::kTypeCastExpr; }
@@ -256,7 +256,7 @@ TypeCastExpr::TypeCastExpr(Expr *expr, QualType to) : Expr(to), expr_{expr} {}
  */
 BinaryOpExpr *BinaryOpExpr::Get(Tag tag, Expr *lhs, Expr *rhs) {
   assert(lhs != nullptr && rhs != nullptr);
-  return new (BinaryOpExprPool.malloc()) BinaryOpExpr{tag, lhs, rhs};
+  return new (AstArena().Allocate<BinaryOpExpr>()) BinaryOpExpr{tag, lhs, rhs};
 }
 
 AstNodeType BinaryOpExpr::Kind() const { return AstNodeType::kBinaryOpExpr; }
@@ -509,7 +509,8 @@ void BinaryOpExpr::CommaOpCheck() { type_ = rhs_->GetQualType(); }
  */
 ConditionOpExpr *ConditionOpExpr::Get(Expr *cond, Expr *lhs, Expr *rhs) {
   assert(cond != nullptr && lhs != nullptr && rhs != nullptr);
-  return new (ConditionOpExprPool.malloc()) ConditionOpExpr{cond, lhs, rhs};
+  return new (AstArena().Allocate<ConditionOpExpr>())
+      ConditionOpExpr{cond, lhs, rhs};
 }
 
 AstNodeType ConditionOpExpr::Kind() const {
@@ -586,7 +587,8 @@ ConditionOpExpr::ConditionOpExpr(Expr *cond, Expr *lhs, Expr *rhs)
  */
 FuncCallExpr *FuncCallExpr::Get(Expr *callee, std::vector<Expr *> args) {
   assert(callee != nullptr);
-  return new (FuncCallExprPool.malloc()) FuncCallExpr{callee, std::move(args)};
+  return new (AstArena().Allocate<FuncCallExpr>())
+      FuncCallExpr{callee, std::move(args)};
 }
 
 AstNodeType FuncCallExpr::Kind() const { return AstNodeType::kFuncCallExpr; }
@@ -647,7 +649,7 @@ Type *FuncCallExpr::GetFuncType() const { return callee_->GetType(); }
 
 Expr *FuncCallExpr::GetCallee() const { return callee_; }
 
-const std::vector<Expr *> &FuncCallExpr::GetArgs() const { return args_; }
+const ArenaVector<Expr *> &FuncCallExpr::GetArgs() const { return args_; }
 
 void FuncCallExpr::SetVaArgType(Type *va_arg_type) {
   va_arg_type_ = va_arg_type;
@@ -656,23 +658,23 @@ void FuncCallExpr::SetVaArgType(Type *va_arg_type) {
 Type *FuncCallExpr::GetVaArgType() const { return va_arg_type_; }
 
 FuncCallExpr::FuncCallExpr(Expr *callee, std::vector<Expr *> args)
-    : callee_{callee}, args_{std::move(args)} {}
+    : callee_{callee}, args_{args} {}
 
 /*
  * Constant
  */
 ConstantExpr *ConstantExpr::Get(std::int32_t val) {
-  return new (ConstantExprPool.malloc()) ConstantExpr{val};
+  return new (AstArena().Allocate<ConstantExpr>()) ConstantExpr{val};
 }
 
 ConstantExpr *ConstantExpr::Get(Type *type, std::uint64_t val) {
   assert(type != nullptr);
-  return new (ConstantExprPool.malloc()) ConstantExpr{type, val};
+  return new (AstArena().Allocate<ConstantExpr>()) ConstantExpr{type, val};
 }
 
 ConstantExpr *ConstantExpr::Get(Type *type, const std::string &str) {
   assert(type != nullptr);
-  return new (ConstantExprPool.malloc()) ConstantExpr{type, str};
+  return new (AstArena().Allocate<ConstantExpr>()) ConstantExpr{type, str};
 }
 
 AstNodeType ConstantExpr::Kind() const { return AstNodeType::kConstantExpr; }
@@ -716,7 +718,8 @@ StringLiteralExpr *StringLiteralExpr::Get(const std::string &val) {
 
 StringLiteralExpr *StringLiteralExpr::Get(Type *type, const std::string &val) {
   assert(type != nullptr);
-  return new (StringLiteralExprPool.malloc()) StringLiteralExpr{type, val};
+  return new (AstArena().Allocate<StringLiteralExpr>())
+      StringLiteralExpr{type, val};
 }
 
 AstNodeType StringLiteralExpr::Kind() const {
@@ -741,8 +744,9 @@ StringLiteralExpr::StringLiteralExpr(Type *type, const std::string &val)
 
 std::pair<llvm::Constant *, llvm::Constant *> StringLiteralExpr::Create()
     const {
-  auto iter{StringMap.find(str_)};
-  if (iter != std::end(StringMap)) {
+  auto &string_map{GetContext().string_map};
+  auto iter{string_map.find(str_)};
+  if (iter != std::end(string_map)) {
     return {iter->second.first, iter->second.second};
   }
 
@@ -761,7 +765,7 @@ std::pair<llvm::Constant *, llvm::Constant *> StringLiteralExpr::Create()
       }
       // 空字符
       values.push_back(0);
-      arr = llvm::ConstantDataArray::get(Context, values);
+      arr = llvm::ConstantDataArray::get(Context(), values);
     } break;
     case 2: {
       std::vector<std::uint16_t> values;
@@ -770,7 +774,7 @@ std::pair<llvm::Constant *, llvm::Constant *> StringLiteralExpr::Create()
         str += 2;
       }
       values.push_back(0);
-      arr = llvm::ConstantDataArray::get(Context, values);
+      arr = llvm::ConstantDataArray::get(Context(), values);
     } break;
     case 4: {
       std::vector<std::uint32_t> values;
@@ -779,7 +783,7 @@ std::pair<llvm::Constant *, llvm::Constant *> StringLiteralExpr::Create()
         str += 4;
       }
       values.push_back(0);
-      arr = llvm::ConstantDataArray::get(Context, values);
+      arr = llvm::ConstantDataArray::get(Context(), values);
     } break;
     default:
       assert(false);
@@ -787,11 +791,11 @@ std::pair<llvm::Constant *, llvm::Constant *> StringLiteralExpr::Create()
 
   auto string{CreateGlobalString(arr, width)};
 
-  auto zero{llvm::ConstantInt::get(Builder.getInt64Ty(), 0)};
+  auto zero{llvm::ConstantInt::get(Builder().getInt64Ty(), 0)};
   llvm::Constant *indices[]{zero, zero};
   ptr = llvm::ConstantExpr::getInBoundsGetElementPtr(nullptr, string, indices);
 
-  StringMap[str_] = {arr, ptr};
+  string_map[str_] = {arr, ptr};
 
   return {arr, ptr};
 }
@@ -799,9 +803,9 @@ std::pair<llvm::Constant *, llvm::Constant *> StringLiteralExpr::Create()
 /*
  * Identifier
  */
-IdentifierExpr *IdentifierExpr::Get(const std::string &name, QualType type,
+IdentifierExpr *IdentifierExpr::Get(Symbol name, QualType type,
                                     enum Linkage linkage, bool is_type_name) {
-  return new (IdentifierExprPool.malloc())
+  return new (AstArena().Allocate<IdentifierExpr>())
       IdentifierExpr{name, type, linkage, is_type_name};
 }
 
@@ -817,7 +821,9 @@ bool IdentifierExpr::IsLValue() const { return false; }
 
 enum Linkage IdentifierExpr::GetLinkage() const { return linkage_; }
 
-const std::string &IdentifierExpr::GetName() const { return name_; }
+const std::string &IdentifierExpr::GetName() const { return name_.GetName(); }
+
+Symbol IdentifierExpr::GetSymbol() const { return name_; }
 
 bool IdentifierExpr::IsTypeName() const { return is_type_name_; }
 
@@ -833,15 +839,15 @@ const ObjectExpr *IdentifierExpr::ToObjectExpr() const {
   return dynamic_cast<const ObjectExpr *>(this);
 }
 
-IdentifierExpr::IdentifierExpr(const std::string &name, QualType type,
+IdentifierExpr::IdentifierExpr(Symbol name, QualType type,
                                enum Linkage linkage, bool is_type_name)
     : Expr{type}, name_{name}, linkage_{linkage}, is_type_name_{is_type_name} {}
 
 /*
  * Enumerator
  */
-EnumeratorExpr *EnumeratorExpr::Get(const std::string &name, std::int32_t val) {
-  return new (EnumeratorExprPool.malloc()) EnumeratorExpr{name, val};
+EnumeratorExpr *EnumeratorExpr::Get(Symbol name, std::int32_t val) {
+  return new (AstArena().Allocate<EnumeratorExpr>()) EnumeratorExpr{name, val};
 }
 
 AstNodeType EnumeratorExpr::Kind() const {
@@ -856,18 +862,18 @@ bool EnumeratorExpr::IsLValue() const { return false; }
 
 std::int32_t EnumeratorExpr::GetVal() const { return val_; }
 
-EnumeratorExpr::EnumeratorExpr(const std::string &name, std::int32_t val)
+EnumeratorExpr::EnumeratorExpr(Symbol name, std::int32_t val)
     : IdentifierExpr{name, ArithmeticType::Get(kInt), Linkage::kNone, false},
       val_{val} {}
 
 /*
  * Object
  */
-ObjectExpr *ObjectExpr::Get(const std::string &name, QualType type,
+ObjectExpr *ObjectExpr::Get(Symbol name, QualType type,
                             std::uint32_t storage_class_spec,
                             enum Linkage linkage, bool anonymous,
                             std::int32_t bit_field_width) {
-  return new (ObjectExprPool.malloc()) ObjectExpr{
+  return new (AstArena().Allocate<ObjectExpr>()) ObjectExpr{
       name, type, storage_class_spec, linkage, anonymous, bit_field_width};
 }
 
@@ -924,7 +930,7 @@ llvm::GlobalVariable *ObjectExpr::GetGlobalPtr() const {
 
   if (IsAnonymous()) {
     ptr = new llvm::GlobalVariable(
-        *Module, GetType()->GetLLVMType(), GetQualType().IsConst(),
+        Module(), GetType()->GetLLVMType(), GetQualType().IsConst(),
         llvm::GlobalValue::InternalLinkage, GetDecl()->GetConstant(),
         ".compoundliteral");
   } else if (IsGlobalVar()) {
@@ -932,16 +938,18 @@ llvm::GlobalVariable *ObjectExpr::GetGlobalPtr() const {
     return ptr;
   } else if (IsLocalStaticVar()) {
     assert(!std::empty(func_name_));
-    auto name{func_name_ + "." + name_};
+    auto name{func_name_ + "." + GetName()};
 
-    if (auto iter{GlobalVarMap.find(name)}; iter != std::end(GlobalVarMap)) {
+    auto &global_var_map{GetContext().global_var_map};
+    if (auto iter{global_var_map.find(name)};
+        iter != std::end(global_var_map)) {
       ptr = iter->second;
     } else {
       ptr = new llvm::GlobalVariable(
-          *Module, GetType()->GetLLVMType(), QualType().IsConst(),
+          Module(), GetType()->GetLLVMType(), QualType().IsConst(),
           llvm::GlobalValue::InternalLinkage,
           GetConstantZero(GetType()->GetLLVMType()), name);
-      GlobalVarMap[name] = ptr;
+      global_var_map[name] = ptr;
     }
   } else {
     assert(false);
@@ -986,7 +994,7 @@ void ObjectExpr::SetFuncName(const std::string &func_name) {
   func_name_ = func_name;
 }
 
-ObjectExpr::ObjectExpr(const std::string &name, QualType type,
+ObjectExpr::ObjectExpr(Symbol name, QualType type,
                        std::uint32_t storage_class_spec, enum Linkage linkage,
                        bool anonymous, std::int32_t bit_field_width)
     : IdentifierExpr{name, type, linkage, false},
@@ -1000,7 +1008,7 @@ ObjectExpr::ObjectExpr(const std::string &name, QualType type,
  */
 StmtExpr *StmtExpr::Get(CompoundStmt *block) {
   assert(block != nullptr);
-  return new (StmtExprPool.malloc()) StmtExpr{block};
+  return new (AstArena().Allocate<StmtExpr>()) StmtExpr{block};
 }
 
 AstNodeType StmtExpr::Kind() const { return AstNodeType::kStmtExpr; }
@@ -1008,7 +1016,7 @@ AstNodeType StmtExpr::Kind() const { return AstNodeType::kStmtExpr; }
 void StmtExpr::Accept(Visitor &visitor) const { visitor.Visit(this); }
 
 void StmtExpr::Check() {
-  auto stmts{block_->GetStmts()};
+  const auto &stmts{block_->GetStmts()};
 
   if (std::size(stmts) > 0 && stmts.back()->Kind() == AstNodeType::kExprStmt) {
     auto expr{dynamic_cast<ExprStmt *>(stmts.back())->GetExpr()};
@@ -1036,9 +1044,9 @@ std::vector<Stmt *> Stmt::Children() const { return {}; }
 /*
  * LabelStmt
  */
-LabelStmt *LabelStmt::Get(const std::string &name, Stmt *stmt) {
+LabelStmt *LabelStmt::Get(Symbol name, Stmt *stmt) {
   assert(stmt != nullptr);
-  return new (LabelStmtPool.malloc()) LabelStmt{name, stmt};
+  return new (AstArena().Allocate<LabelStmt>()) LabelStmt{name, stmt};
 }
 
 AstNodeType LabelStmt::Kind() const { return AstNodeType::kLabelStmt; }
@@ -1051,9 +1059,11 @@ std::vector<Stmt *> LabelStmt::Children() const { return {stmt_}; }
 
 Stmt *LabelStmt::GetStmt() const { return stmt_; }
 
-const std::string &LabelStmt::GetName() const { return name_; }
+const std::string &LabelStmt::GetName() const { return name_.GetName(); }
+
+Symbol LabelStmt::GetSymbol() const { return name_; }
 
-LabelStmt::LabelStmt(const std::string &name, Stmt *stmt)
+LabelStmt::LabelStmt(Symbol name, Stmt *stmt)
     : name_{name}, stmt_{stmt} {}
 
 /*
@@ -1061,12 +1071,12 @@ LabelStmt::LabelStmt(const std::string &name, Stmt *stmt)
  */
 CaseStmt *CaseStmt::Get(std::int64_t lhs, Stmt *stmt) {
   assert(stmt != nullptr);
-  return new (CaseStmtPool.malloc()) CaseStmt{lhs, stmt};
+  return new (AstArena().Allocate<CaseStmt>()) CaseStmt{lhs, stmt};
 }
 
 CaseStmt *CaseStmt::Get(std::int64_t lhs, std::int64_t rhs, Stmt *stmt) {
   assert(stmt != nullptr);
-  return new (CaseStmtPool.malloc()) CaseStmt{lhs, rhs, stmt};
+  return new (AstArena().Allocate<CaseStmt>()) CaseStmt{lhs, rhs, stmt};
 }
 
 AstNodeType CaseStmt::Kind() const { return AstNodeType::kCaseStmt; }
@@ -1093,7 +1103,7 @@ CaseStmt::CaseStmt(std::int64_t lhs, std::int64_t rhs, Stmt *stmt)
  */
 DefaultStmt *DefaultStmt::Get(Stmt *block) {
   assert(block != nullptr);
-  return new (DefaultStmtPool.malloc()) DefaultStmt{block};
+  return new (AstArena().Allocate<DefaultStmt>()) DefaultStmt{block};
 }
 
 AstNodeType DefaultStmt::Kind() const { return AstNodeType::kDefaultStmt; }
@@ -1112,11 +1122,12 @@ DefaultStmt::DefaultStmt(Stmt *block) : stmt_{block} {}
  * CompoundStmt
  */
 CompoundStmt *CompoundStmt::Get() {
-  return new (CompoundStmtPool.malloc()) CompoundStmt{};
+  return new (AstArena().Allocate<CompoundStmt>()) CompoundStmt{};
 }
 
 CompoundStmt *CompoundStmt::Get(std::vector<Stmt *> stmts) {
-  return new (CompoundStmtPool.malloc()) CompoundStmt{std::move(stmts)};
+  return new (AstArena().Allocate<CompoundStmt>())
+      CompoundStmt{std::move(stmts)};
 }
 
 AstNodeType CompoundStmt::Kind() const { return AstNodeType::kCompoundStmt; }
@@ -1125,9 +1136,11 @@ void CompoundStmt::Accept(Visitor &visitor) const { visitor.Visit(this); }
 
 void CompoundStmt::Check() {}
 
-std::vector<Stmt *> CompoundStmt::Children() const { return stmts_; }
+std::vector<Stmt *> CompoundStmt::Children() const {
+  return {std::begin(stmts_), std::end(stmts_)};
+}
 
-const std::vector<Stmt *> &CompoundStmt::GetStmts() const { return stmts_; }
+const ArenaVector<Stmt *> &CompoundStmt::GetStmts() const { return stmts_; }
 
 void CompoundStmt::AddStmt(Stmt *stmt) {
   // 非 typedef
@@ -1137,13 +1150,13 @@ void CompoundStmt::AddStmt(Stmt *stmt) {
 }
 
 CompoundStmt::CompoundStmt(std::vector<Stmt *> stmts)
-    : stmts_{std::move(stmts)} {}
+    : stmts_{stmts} {}
 
 /*
  * ExprStmt
  */
 ExprStmt *ExprStmt::Get(Expr *expr) {
-  return new (ExprStmtPool.malloc()) ExprStmt{expr};
+  return new (AstArena().Allocate<ExprStmt>()) ExprStmt{expr};
 }
 
 AstNodeType ExprStmt::Kind() const { return AstNodeType::kExprStmt; }
@@ -1161,7 +1174,8 @@ ExprStmt::ExprStmt(Expr *expr) : expr_{expr} {}
  */
 IfStmt *IfStmt::Get(Expr *cond, Stmt *then_block, Stmt *else_block) {
   assert(cond != nullptr && then_block != nullptr);
-  return new (IfStmtPool.malloc()) IfStmt{cond, then_block, else_block};
+  return new (AstArena().Allocate<IfStmt>())
+      IfStmt{cond, then_block, else_block};
 }
 
 AstNodeType IfStmt::Kind() const { return AstNodeType::kIfStmt; }
@@ -1195,7 +1209,7 @@ IfStmt::IfStmt(Expr *cond, Stmt *then_block, Stmt *else_block)
  */
 SwitchStmt *SwitchStmt::Get(Expr *cond, Stmt *block) {
   assert(cond != nullptr && block != nullptr);
-  return new (SwitchStmtPool.malloc()) SwitchStmt{cond, block};
+  return new (AstArena().Allocate<SwitchStmt>()) SwitchStmt{cond, block};
 }
 
 AstNodeType SwitchStmt::Kind() const { return AstNodeType::kSwitchStmt; }
@@ -1224,7 +1238,7 @@ SwitchStmt::SwitchStmt(Expr *cond, Stmt *block) : cond_{cond}, stmt_{block} {}
  */
 WhileStmt *WhileStmt::Get(Expr *cond, Stmt *block) {
   assert(cond != nullptr && block != nullptr);
-  return new (WhileStmtPool.malloc()) WhileStmt{cond, block};
+  return new (AstArena().Allocate<WhileStmt>()) WhileStmt{cond, block};
 }
 
 AstNodeType WhileStmt::Kind() const { return AstNodeType::kWhileStmt; }
@@ -1252,7 +1266,7 @@ WhileStmt::WhileStmt(Expr *cond, Stmt *block)
  */
 DoWhileStmt *DoWhileStmt::Get(Expr *cond, Stmt *block) {
   assert(cond != nullptr && block != nullptr);
-  return new (DoWhileStmtPool.malloc()) DoWhileStmt{cond, block};
+  return new (AstArena().Allocate<DoWhileStmt>()) DoWhileStmt{cond, block};
 }
 
 AstNodeType DoWhileStmt::Kind() const { return AstNodeType::kDoWhileStmt; }
@@ -1280,7 +1294,8 @@ DoWhileStmt::DoWhileStmt(Expr *cond, Stmt *block)
  */
 ForStmt *ForStmt::Get(Expr *init, Expr *cond, Expr *inc, Stmt *block,
                       Stmt *decl) {
-  return new (ForStmtPool.malloc()) ForStmt{init, cond, inc, block, decl};
+  return new (AstArena().Allocate<ForStmt>())
+      ForStmt{init, cond, inc, block, decl};
 }
 
 AstNodeType ForStmt::Kind() const { return AstNodeType::kForStmt; }
@@ -1312,13 +1327,13 @@ ForStmt::ForStmt(Expr *init, Expr *cond, Expr *inc, Stmt *block, Stmt *decl)
 /*
  * GotoStmt
  */
-GotoStmt *GotoStmt::Get(const std::string &name) {
-  return new (GotoStmtPool.malloc()) GotoStmt{name};
+GotoStmt *GotoStmt::Get(Symbol name) {
+  return new (AstArena().Allocate<GotoStmt>()) GotoStmt{name};
 }
 
 GotoStmt *GotoStmt::Get(LabelStmt *label) {
   assert(label != nullptr);
-  return new (GotoStmtPool.malloc()) GotoStmt{label};
+  return new (AstArena().Allocate<GotoStmt>()) GotoStmt{label};
 }
 
 AstNodeType GotoStmt::Kind() const { return AstNodeType::kGotoStmt; }
@@ -1331,9 +1346,11 @@ const LabelStmt *GotoStmt::GetLabel() const { return label_; }
 
 void GotoStmt::SetLabel(LabelStmt *label) { label_ = label; }
 
-const std::string &GotoStmt::GetName() const { return name_; }
+const std::string &GotoStmt::GetName() const { return name_.GetName(); }
 
-GotoStmt::GotoStmt(const std::string &name) : name_{name} {}
+Symbol GotoStmt::GetSymbol() const { return name_; }
+
+GotoStmt::GotoStmt(Symbol name) : name_{name} {}
 
 GotoStmt::GotoStmt(LabelStmt *label) : label_{label} {}
 
@@ -1341,7 +1358,7 @@ GotoStmt::GotoStmt(LabelStmt *label) : label_{label} {}
  * ContinueStmt
  */
 ContinueStmt *ContinueStmt::Get() {
-  return new (ContinueStmtPool.malloc()) ContinueStmt{};
+  return new (AstArena().Allocate<ContinueStmt>()) ContinueStmt{};
 }
 
 AstNodeType ContinueStmt::Kind() const { return AstNodeType::kContinueStmt; }
@@ -1353,7 +1370,9 @@ void ContinueStmt::Check() {}
 /*
  * BreakStmt
  */
-BreakStmt *BreakStmt::Get() { return new (BreakStmtPool.malloc()) BreakStmt{}; }
+BreakStmt *BreakStmt::Get() {
+  return new (AstArena().Allocate<BreakStmt>()) BreakStmt{};
+}
 
 AstNodeType BreakStmt::Kind() const { return AstNodeType::kBreakStmt; }
 
@@ -1365,7 +1384,7 @@ void BreakStmt::Check() {}
  * ReturnStmt
  */
 ReturnStmt *ReturnStmt::Get(Expr *expr) {
-  return new (ReturnStmtPool.malloc()) ReturnStmt{expr};
+  return new (AstArena().Allocate<ReturnStmt>()) ReturnStmt{expr};
 }
 
 AstNodeType ReturnStmt::Kind() const { return AstNodeType::kReturnStmt; }
@@ -1382,7 +1401,7 @@ ReturnStmt::ReturnStmt(Expr *expr) : expr_{expr} {}
  * TranslationUnit
  */
 TranslationUnit *TranslationUnit::Get() {
-  return new (TranslationUnitPool.malloc()) TranslationUnit{};
+  return new (AstArena().Allocate<TranslationUnit>()) TranslationUnit{};
 }
 
 AstNodeType TranslationUnit::Kind() const {
@@ -1440,7 +1459,7 @@ const std::vector<std::tuple<Type *, std::int32_t, std::int32_t, std::int32_t>>
  */
 Declaration *Declaration::Get(IdentifierExpr *ident) {
   assert(ident != nullptr);
-  return new (DeclarationPool.malloc()) Declaration{ident};
+  return new (AstArena().Allocate<Declaration>()) Declaration{ident};
 }
 
 AstNodeType Declaration::Kind() const { return AstNodeType::kDeclaration; }
@@ -1525,7 +1544,7 @@ Declaration::Declaration(IdentifierExpr *ident) : ident_{ident} {}
  * FuncDef
  */
 FuncDef *FuncDef::Get(IdentifierExpr *ident) {
-  return new (FuncDefPool.malloc()) FuncDef{ident};
+  return new (AstArena().Allocate<FuncDef>()) FuncDef{ident};
 }
 
 AstNodeType FuncDef::Kind() const { return AstNodeType::kFuncDef; }
@@ -0,0 +1,221 @@
+//
+// Created by kaiser on 2026/10/16.
+//
+
+#include "cache.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/Support/Host.h>
+#include <llvm/Support/SHA1.h>
+
+#include "token.h"
+#include "util.h"
+
+namespace kcc {
+
+namespace {
+
+std::atomic<std::uint64_t> Hits;
+std::atomic<std::uint64_t> Misses;
+std::atomic<bool> Stored;
+
+}  // namespace
+
+const std::filesystem::path &GetCacheDir() {
+  static const auto dir{[] {
+    if (!std::empty(CacheDir)) {
+      return std::filesystem::path{CacheDir.getValue()};
+    }
+    if (auto env{std::getenv("KCC_CACHE_DIR")}; env != nullptr) {
+      return std::filesystem::path{env};
+    }
+    if (auto env{std::getenv("XDG_CACHE_HOME")}; env != nullptr) {
+      return std::filesystem::path{env} / "kcc";
+    }
+    if (auto env{std::getenv("HOME")}; env != nullptr) {
+      return std::filesystem::path{env} / ".cache" / "kcc";
+    }
+    return std::filesystem::temp_directory_path() / "kcc-cache";
+  }()};
+
+  return dir;
+}
+
+namespace {
+
+// 前两个字符作为子目录, 避免单个目录中的文件过多
+std::filesystem::path GetCachePath(const std::string &key) {
+  return GetCacheDir() / key.substr(0, 2) / (key.substr(2) + ".o");
+}
+
+}  // namespace
+
+std::string GetCacheKey(const std::string &file_name,
+                        const std::vector<Token> &tokens) {
+  llvm::SHA1 hasher;
+
+  // 目标文件中会记录源文件名, 调试信息中还会记录编译时的工作目录
+  std::error_code error_code;
+  auto comp_dir{Debug ? std::filesystem::current_path(error_code).string()
+                      : std::string{}};
+
+  for (const auto &item :
+       {std::string{KCC_VERSION}, llvm::sys::getDefaultTargetTriple(),
+        std::to_string(static_cast<std::int32_t>(OptimizationLevel.getValue())),
+        std::to_string(Debug), std::to_string(FPic),
+        std::to_string(static_cast<std::int32_t>(FLto.getValue())),
+        file_name, comp_dir}) {
+    hasher.update(item);
+    hasher.update(llvm::StringRef{"", 1});
+  }
+
+  // 记号的位置会影响调试信息, 也需要计入
+  std::string file;
+  for (const auto &tok : tokens) {
+    auto loc{tok.GetLoc()};
+    if (auto name{loc.GetFileName()}; name != file) {
+      file = name;
+      hasher.update(file);
+      hasher.update(llvm::StringRef{"", 1});
+    }
+
+    std::int32_t values[]{static_cast<std::int32_t>(tok.GetTag()),
+                          loc.GetRow(), loc.GetColumn()};
+    hasher.update(llvm::ArrayRef<std::uint8_t>{
+        reinterpret_cast<const std::uint8_t *>(values), sizeof(values)});
+    auto str{tok.GetStr()};
+    hasher.update(llvm::StringRef{str.data(), std::size(str)});
+    hasher.update(llvm::StringRef{"", 1});
+  }
+
+  return llvm::toHex(hasher.final(), true);
+}
+
+bool CacheLookup(const std::string &key, const std::string &obj_file) {
+  auto path{GetCachePath(key)};
+
+  // 缓存项可能随时被其他进程淘汰, 任何失败都视为未命中
+  std::error_code error_code;
+  std::filesystem::copy_file(
+      path, obj_file, std::filesystem::copy_options::overwrite_existing,
+      error_code);
+  if (error_code) {
+    ++Misses;
+    return false;
+  }
+
+  // 用修改时间记录最近一次使用
+  std::filesystem::last_write_time(
+      path, std::filesystem::file_time_type::clock::now(), error_code);
+
+  ++Hits;
+  return true;
+}
+
+void CacheStore(const std::string &key, const std::string &obj_file) {
+  auto path{GetCachePath(key)};
+
+  std::error_code error_code;
+  std::filesystem::create_directories(path.parent_path(), error_code);
+  if (error_code) {
+    return;
+  }
+
+  // 先写入临时文件再重命名, 并发的编译进程只会看到完整的缓存项
+  auto temp{path};
+  temp += ".tmp." + std::to_string(getpid()) + "." +
+          std::to_string(std::hash<std::thread::id>{}(
+              std::this_thread::get_id()));
+
+  std::filesystem::copy_file(
+      obj_file, temp, std::filesystem::copy_options::overwrite_existing,
+      error_code);
+  if (!error_code) {
+    std::filesystem::rename(temp, path, error_code);
+  }
+
+  if (error_code) {
+    std::filesystem::remove(temp, error_code);
+  } else {
+    Stored = true;
+  }
+}
+
+void CacheTrim() {
+  if (!Stored) {
+    return;
+  }
+
+  struct Entry {
+    std::filesystem::file_time_type time;
+    std::filesystem::path path;
+    std::uintmax_t size;
+  };
+
+  std::vector<Entry> entries;
+  std::uintmax_t total{};
+
+  std::error_code error_code;
+  for (std::filesystem::recursive_directory_iterator iter{GetCacheDir(),
+                                                          error_code},
+       end;
+       !error_code && iter != end; iter.increment(error_code)) {
+    if (!iter->is_regular_file(error_code) ||
+        iter->path().extension() != ".o") {
+      continue;
+    }
+
+    auto time{iter->last_write_time(error_code)};
+    auto size{iter->file_size(error_code)};
+    if (!error_code) {
+      total += size;
+      entries.push_back({time, iter->path(), size});
+    }
+    error_code.clear();
+  }
+
+  auto limit{static_cast<std::uintmax_t>(CacheSize) * 1024 * 1024};
+  if (total <= limit) {
+    return;
+  }
+
+  std::sort(std::begin(entries), std::end(entries),
+            [](const auto &lhs, const auto &rhs) {
+              return lhs.time < rhs.time;
+            });
+
+  // 一次多淘汰一些, 避免之后每次编译都要清理
+  limit = limit / 10 * 9;
+  for (const auto &item : entries) {
+    if (total <= limit) {
+      break;
+    }
+
+    if (std::filesystem::remove(item.path, error_code)) {
+      total -= item.size;
+    }
+  }
+}
+
+void PrintCacheStatistics() {
+  if (Timing && FCache) {
+    std::cout << "Cache: " << Hits << " hits, " << Misses << " misses"
+              << std::endl;
+  }
+}
+
+}  // namespace kcc
@@ -227,14 +227,14 @@ void CalcConstantExpr::Visit(const IdentifierExpr *node) {
 
   auto name{node->GetName()};
 
-  auto func{Module->getFunction(name)};
+  auto func{Module().getFunction(name)};
   if (!func) {
     func = llvm::Function::Create(
         llvm::cast<llvm::FunctionType>(type->GetLLVMType()),
         node->GetLinkage() == Linkage::kInternal
             ? llvm::Function::InternalLinkage
             : llvm::Function::ExternalLinkage,
-        name, Module.get());
+        name, &Module());
   }
 
   val_ = func;
@@ -304,9 +304,9 @@ llvm::Constant *CalcConstantExpr::NegOp(llvm::Constant *value,
 llvm::Constant *CalcConstantExpr::LogicNotOp(llvm::Constant *value) {
   value = ConstantCastToBool(value);
   value =
-      llvm::ConstantExpr::getXor(value, llvm::ConstantInt::getTrue(Context));
+      llvm::ConstantExpr::getXor(value, llvm::ConstantInt::getTrue(Context()));
 
-  return llvm::ConstantExpr::getZExt(value, Builder.getInt32Ty());
+  return llvm::ConstantExpr::getZExt(value, Builder().getInt32Ty());
 }
 
 // 运算对象可以是:
@@ -348,7 +348,7 @@ llvm::Constant *CalcConstantExpr::Addr(const UnaryOpExpr *node) {
     assert(member != nullptr);
 
     return llvm::ConstantExpr::getInBoundsGetElementPtr(
-        nullptr, lhs, Builder.getInt64(member->GetIndexs().back().second));
+        nullptr, lhs, Builder().getInt64(member->GetIndexs().back().second));
   } else {
     Throw();
     return nullptr;
@@ -391,12 +391,13 @@ llvm::Constant *CalcConstantExpr::SubOp(llvm::Constant *lhs,
   } else if (IsPointerTy(lhs) && IsPointerTy(rhs)) {
     auto type{lhs->getType()->getPointerElementType()};
 
-    lhs = ConstantCastTo(lhs, Builder.getInt64Ty(), true);
-    rhs = ConstantCastTo(rhs, Builder.getInt64Ty(), true);
+    lhs = ConstantCastTo(lhs, Builder().getInt64Ty(), true);
+    rhs = ConstantCastTo(rhs, Builder().getInt64Ty(), true);
 
     auto value{SubOp(lhs, rhs, true)};
     return DivOp(
-        value, Builder.getInt64(Module->getDataLayout().getTypeAllocSize(type)),
+        value,
+        Builder().getInt64(Module().getDataLayout().getTypeAllocSize(type)),
         true);
   } else {
     assert(false);
@@ -494,7 +495,7 @@ llvm::Constant *CalcConstantExpr::LessEqualOp(llvm::Constant *lhs,
     return nullptr;
   }
 
-  return llvm::ConstantExpr::getZExt(value, Builder.getInt32Ty());
+  return llvm::ConstantExpr::getZExt(value, Builder().getInt32Ty());
 }
 
 llvm::Constant *CalcConstantExpr::LessOp(llvm::Constant *lhs,
@@ -517,7 +518,7 @@ llvm::Constant *CalcConstantExpr::LessOp(llvm::Constant *lhs,
     return nullptr;
   }
 
-  return llvm::ConstantExpr::getZExt(value, Builder.getInt32Ty());
+  return llvm::ConstantExpr::getZExt(value, Builder().getInt32Ty());
 }
 
 llvm::Constant *CalcConstantExpr::GreaterEqualOp(llvm::Constant *lhs,
@@ -540,7 +541,7 @@ llvm::Constant *CalcConstantExpr::GreaterEqualOp(llvm::Constant *lhs,
     return nullptr;
   }
 
-  return llvm::ConstantExpr::getZExt(value, Builder.getInt32Ty());
+  return llvm::ConstantExpr::getZExt(value, Builder().getInt32Ty());
 }
 
 llvm::Constant *CalcConstantExpr::GreaterOp(llvm::Constant *lhs,
@@ -563,7 +564,7 @@ llvm::Constant *CalcConstantExpr::GreaterOp(llvm::Constant *lhs,
     return nullptr;
   }
 
-  return llvm::ConstantExpr::getZExt(value, Builder.getInt32Ty());
+  return llvm::ConstantExpr::getZExt(value, Builder().getInt32Ty());
 }
 
 llvm::Constant *CalcConstantExpr::EqualOp(llvm::Constant *lhs,
@@ -579,7 +580,7 @@ llvm::Constant *CalcConstantExpr::EqualOp(llvm::Constant *lhs,
     return nullptr;
   }
 
-  return llvm::ConstantExpr::getZExt(value, Builder.getInt32Ty());
+  return llvm::ConstantExpr::getZExt(value, Builder().getInt32Ty());
 }
 
 llvm::Constant *CalcConstantExpr::NotEqualOp(llvm::Constant *lhs,
@@ -595,7 +596,7 @@ llvm::Constant *CalcConstantExpr::NotEqualOp(llvm::Constant *lhs,
     return nullptr;
   }
 
-  return llvm::ConstantExpr::getZExt(value, Builder.getInt32Ty());
+  return llvm::ConstantExpr::getZExt(value, Builder().getInt32Ty());
 }
 
 llvm::Constant *CalcConstantExpr::LogicOrOp(const BinaryOpExpr *node) {
@@ -603,9 +604,9 @@ llvm::Constant *CalcConstantExpr::LogicOrOp(const BinaryOpExpr *node) {
 
   if (lhs->isZeroValue()) {
     auto rhs{Throw(CalcConstantExpr{}.Calc(node->GetRHS()))};
-    return llvm::ConstantInt::get(Builder.getInt32Ty(), !rhs->isZeroValue());
+    return llvm::ConstantInt::get(Builder().getInt32Ty(), !rhs->isZeroValue());
   } else {
-    return llvm::ConstantInt::get(Builder.getInt32Ty(), 1);
+    return llvm::ConstantInt::get(Builder().getInt32Ty(), 1);
   }
 }
 
@@ -613,10 +614,10 @@ llvm::Constant *CalcConstantExpr::LogicAndOp(const BinaryOpExpr *node) {
   auto lhs{Throw(CalcConstantExpr{}.Calc(node->GetLHS()))};
 
   if (lhs->isZeroValue()) {
-    return llvm::ConstantInt::get(Builder.getInt32Ty(), 0);
+    return llvm::ConstantInt::get(Builder().getInt32Ty(), 0);
   } else {
     auto rhs{Throw(CalcConstantExpr{}.Calc(node->GetRHS()))};
-    return llvm::ConstantInt::get(Builder.getInt32Ty(), !rhs->isZeroValue());
+    return llvm::ConstantInt::get(Builder().getInt32Ty(), !rhs->isZeroValue());
   }
 }
 
@@ -47,11 +47,11 @@ void CodeGen::GenCode(const TranslationUnit *root) {
     debug_info_->Finalize();
   }
 
-  if (llvm::verifyModule(*Module, &llvm::errs())) {
+  if (llvm::verifyModule(Module(), &llvm::errs())) {
 #ifdef DEV
-    Warning("module '{}' is broken", Module->getName().str());
+    Warning("module '{}' is broken", Module().getName().str());
 #else
-    Error("module '{}' is broken", Module->getName().str());
+    Error("module '{}' is broken", Module().getName().str());
 #endif
   }
 
@@ -66,9 +66,9 @@ llvm::BasicBlock *CodeGen::CreateBasicBlock(const std::string &name,
                                             llvm::Function *parent) {
   (void)name;
 #ifdef NDEBUG
-  return llvm::BasicBlock::Create(Context, "", parent);
+  return llvm::BasicBlock::Create(Context(), "", parent);
 #else
-  return llvm::BasicBlock::Create(Context, name, parent);
+  return llvm::BasicBlock::Create(Context(), name, parent);
 #endif
 }
 
@@ -81,21 +81,21 @@ void CodeGen::EmitBlock(llvm::BasicBlock *bb, bool is_finished) {
   }
 
   func_->getBasicBlockList().push_back(bb);
-  Builder.SetInsertPoint(bb);
+  Builder().SetInsertPoint(bb);
 }
 
 void CodeGen::EmitBranch(llvm::BasicBlock *target) {
-  auto curr{Builder.GetInsertBlock()};
+  auto curr{Builder().GetInsertBlock()};
 
   if (curr && !curr->getTerminator()) {
-    Builder.CreateBr(target);
+    Builder().CreateBr(target);
   }
 
-  Builder.ClearInsertionPoint();
+  Builder().ClearInsertionPoint();
 }
 
 bool CodeGen::HaveInsertPoint() const {
-  return Builder.GetInsertBlock() != nullptr;
+  return Builder().GetInsertBlock() != nullptr;
 }
 
 void CodeGen::EnsureInsertPoint() {
@@ -147,7 +147,7 @@ void CodeGen::EmitBranchOnBoolExpr(const Expr *expr,
     return;
   }
 
-  Builder.CreateCondBr(EvaluateExprAsBool(expr), true_block, false_block);
+  Builder().CreateCondBr(EvaluateExprAsBool(expr), true_block, false_block);
 }
 
 void CodeGen::SimplifyForwardingBlocks(llvm::BasicBlock *bb) {
@@ -232,8 +232,8 @@ void CodeGen::EmitBranchThroughCleanup(llvm::BasicBlock *dest) {
     return;
   }
 
-  Builder.CreateBr(dest);
-  Builder.ClearInsertionPoint();
+  Builder().CreateBr(dest);
+  Builder().ClearInsertionPoint();
 }
 
 llvm::BasicBlock *CodeGen::GetBasicBlockForLabel(const LabelStmt *label) {
@@ -303,9 +303,9 @@ llvm::Value *CodeGen::GetPtr(const AstNode *node) {
       auto indexs{obj->GetIndexs()};
       for (const auto &[type, index] : indexs) {
         if (type->IsStructTy()) {
-          lhs_ptr = Builder.CreateStructGEP(lhs_ptr, index);
+          lhs_ptr = Builder().CreateStructGEP(lhs_ptr, index);
         } else {
-          lhs_ptr = Builder.CreateBitCast(
+          lhs_ptr = Builder().CreateBitCast(
               lhs_ptr,
               type->StructGetMemberType(index)->GetLLVMType()->getPointerTo());
         }
@@ -313,11 +313,11 @@ llvm::Value *CodeGen::GetPtr(const AstNode *node) {
 
       if (is_bit_field_) {
         if (obj->GetType()->IsBoolTy()) {
-          lhs_ptr = Builder.CreateBitCast(lhs_ptr,
-                                          Builder.getInt8Ty()->getPointerTo());
+          lhs_ptr = Builder().CreateBitCast(
+              lhs_ptr, Builder().getInt8Ty()->getPointerTo());
         } else {
-          lhs_ptr = Builder.CreateBitCast(lhs_ptr,
-                                          Builder.getInt32Ty()->getPointerTo());
+          lhs_ptr = Builder().CreateBitCast(
+              lhs_ptr, Builder().getInt32Ty()->getPointerTo());
         }
       }
 
@@ -434,14 +434,14 @@ void CodeGen::Visit(const FuncDef *node) {
 
     TryEmitParamVar(name, type, ptr, obj->GetLoc());
     // 将参数的值保存到分配的内存中
-    Builder.CreateStore(&arg, ptr, is_volatile_);
+    Builder().CreateStore(&arg, ptr, is_volatile_);
     ++iter;
   }
 
   TryEmitLocation(node);
 
   if (node->GetFuncType()->FuncGetName() == "main") {
-    Builder.CreateStore(Builder.getInt32(0), return_value_);
+    Builder().CreateStore(Builder().getInt32(0), return_value_);
   }
 
   EmitStmt(node->GetBody());
@@ -468,7 +468,7 @@ void CodeGen::DealLocaleDecl(const Declaration *node) {
       assert(std::size(init) == 1);
 
       init.front().GetExpr()->Accept(*this);
-      Builder.CreateStore(result_, obj->GetLocalPtr(), is_volatile_);
+      Builder().CreateStore(result_, obj->GetLocalPtr(), is_volatile_);
       is_volatile_ = false;
     } else if (type->IsAggregateTy()) {
       InitLocalAggregate(node);
@@ -476,13 +476,13 @@ void CodeGen::DealLocaleDecl(const Declaration *node) {
       assert(false);
     }
   } else if (node->HasConstantInit()) {
-    if (ptr->getType() != Builder.getInt8PtrTy()) {
-      result_ = Builder.CreateBitCast(ptr, Builder.getInt8PtrTy());
+    if (ptr->getType() != Builder().getInt8PtrTy()) {
+      result_ = Builder().CreateBitCast(ptr, Builder().getInt8PtrTy());
     }
 
     auto align{llvm::MaybeAlign{static_cast<std::uint64_t>(obj->GetAlign())}};
-    Builder.CreateMemCpy(result_, align, node->GetConstant(), align,
-                         obj->GetType()->GetWidth(), is_volatile_);
+    Builder().CreateMemCpy(result_, align, node->GetConstant(), align,
+                           obj->GetType()->GetWidth(), is_volatile_);
     is_volatile_ = false;
   }
 }
@@ -493,9 +493,10 @@ void CodeGen::InitLocalAggregate(const Declaration *node) {
   auto obj{node->GetObject()};
   auto width{obj->GetType()->GetWidth()};
 
-  result_ = Builder.CreateBitCast(obj->GetLocalPtr(), Builder.getInt8PtrTy());
-  Builder.CreateMemSet(
-      result_, Builder.getInt8(0), width,
+  result_ =
+      Builder().CreateBitCast(obj->GetLocalPtr(), Builder().getInt8PtrTy());
+  Builder().CreateMemSet(
+      result_, Builder().getInt8(0), width,
       llvm::MaybeAlign{static_cast<std::uint64_t>(obj->GetAlign())},
       is_volatile_);
 
@@ -514,15 +515,15 @@ void CodeGen::InitLocalAggregate(const Declaration *node) {
 
       if (type->IsArrayTy() && !width) {
         member_type = type->ArrayGetElementType().GetType();
-        ptr = Builder.CreateInBoundsGEP(
-            ptr, {Builder.getInt64(0), Builder.getInt64(index)});
+        ptr = Builder().CreateInBoundsGEP(
+            ptr, {Builder().getInt64(0), Builder().getInt64(index)});
       } else if (type->IsStructTy()) {
         member_type = type->StructGetMemberType(index).GetType();
-        ptr = Builder.CreateStructGEP(ptr, index);
+        ptr = Builder().CreateStructGEP(ptr, index);
       } else if (type->IsUnionTy()) {
         member_type = type->StructGetMemberType(index).GetType();
-        ptr = Builder.CreateBitCast(ptr,
-                                    member_type->GetLLVMType()->getPointerTo());
+        ptr = Builder().CreateBitCast(
+            ptr, member_type->GetLLVMType()->getPointerTo());
       } else {
         member_type = type;
         break;
@@ -533,21 +534,22 @@ void CodeGen::InitLocalAggregate(const Declaration *node) {
       auto size{member_type->IsBoolTy() ? 8 : 32};
 
       if (member_type->IsBoolTy()) {
-        ptr = Builder.CreateBitCast(ptr, Builder.getInt8PtrTy());
+        ptr = Builder().CreateBitCast(ptr, Builder().getInt8PtrTy());
       } else {
-        ptr = Builder.CreateBitCast(ptr, Builder.getInt32Ty()->getPointerTo());
+        ptr = Builder().CreateBitCast(ptr,
+                                      Builder().getInt32Ty()->getPointerTo());
       }
 
-      result_ = Builder.CreateLoad(ptr, is_volatile_);
+      result_ = Builder().CreateLoad(ptr, is_volatile_);
       result_ = GetBitField(result_, size, bit_field_width, bit_field_begin);
 
-      value = Builder.CreateShl(value, bit_field_begin);
-      value = CastTo(value, Builder.getInt32Ty(),
+      value = Builder().CreateShl(value, bit_field_begin);
+      value = CastTo(value, Builder().getInt32Ty(),
                      item.GetExpr()->GetType()->IsUnsigned());
-      value = Builder.CreateOr(result_, value);
+      value = Builder().CreateOr(result_, value);
     }
 
-    result_ = Builder.CreateStore(value, ptr, is_volatile_);
+    result_ = Builder().CreateStore(value, ptr, is_volatile_);
   }
 
   is_volatile_ = false;
@@ -575,9 +577,9 @@ void CodeGen::StartFunction(const FuncDef *node) {
 
   auto entry{CreateBasicBlock("entry", func_)};
 
-  auto undef{llvm::UndefValue::get(Builder.getInt32Ty())};
+  auto undef{llvm::UndefValue::get(Builder().getInt32Ty())};
   alloc_insert_point_ =
-      new llvm::BitCastInst{undef, Builder.getInt32Ty(), "", entry};
+      new llvm::BitCastInst{undef, Builder().getInt32Ty(), "", entry};
 
   return_block_ = CreateBasicBlock("return");
   return_value_ = nullptr;
@@ -588,11 +590,11 @@ void CodeGen::StartFunction(const FuncDef *node) {
                                            return_type->GetAlign(), "ret.val");
   }
 
-  Builder.SetInsertPoint(entry);
+  Builder().SetInsertPoint(entry);
 }
 
 void CodeGen::FinishFunction(const FuncDef *node) {
-  auto func{Module->getFunction(node->GetName())};
+  auto func{Module().getFunction(node->GetName())};
 
   EmitReturnBlock();
   EmitFunctionEpilog();
@@ -608,7 +610,7 @@ void CodeGen::FinishFunction(const FuncDef *node) {
 }
 
 void CodeGen::EmitReturnBlock() {
-  auto bb{Builder.GetInsertBlock()};
+  auto bb{Builder().GetInsertBlock()};
 
   if (bb) {
     assert(!bb->getTerminator());
@@ -631,13 +633,13 @@ void CodeGen::EmitFunctionEpilog() {
   llvm::Value *value{};
 
   if (return_value_) {
-    value = Builder.CreateLoad(return_value_);
+    value = Builder().CreateLoad(return_value_);
   }
 
   if (value) {
-    Builder.CreateRet(value);
+    Builder().CreateRet(value);
   } else {
-    Builder.CreateRetVoid();
+    Builder().CreateRetVoid();
   }
 }
 
@@ -11,6 +11,7 @@
 #include <llvm/IR/CFG.h>
 #include <llvm/IR/Constant.h>
 #include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/Intrinsics.h>
 #include <llvm/Support/Casting.h>
 
 #include "calc.h"
@@ -45,7 +46,7 @@ void CodeGen::Visit(const UnaryOpExpr *node) {
     case Tag::kTilde:
       node->GetExpr()->Accept(*this);
       TryEmitLocation(node);
-      result_ = Builder.CreateNot(result_);
+      result_ = Builder().CreateNot(result_);
       break;
     case Tag::kExclaim:
       node->GetExpr()->Accept(*this);
@@ -174,7 +175,7 @@ void CodeGen::Visit(const ConditionOpExpr *node) {
     auto lhs{result_};
     node->GetRHS()->Accept(*this);
     TryEmitLocation(node);
-    result_ = Builder.CreateSelect(cond, lhs, result_);
+    result_ = Builder().CreateSelect(cond, lhs, result_);
     return;
   }
 
@@ -187,13 +188,13 @@ void CodeGen::Visit(const ConditionOpExpr *node) {
   EmitBlock(lhs_block);
   node->GetLHS()->Accept(*this);
   auto lhs{result_};
-  lhs_block = Builder.GetInsertBlock();
+  lhs_block = Builder().GetInsertBlock();
   EmitBranch(end_block);
 
   EmitBlock(rhs_block);
   node->GetRHS()->Accept(*this);
   auto rhs{result_};
-  rhs_block = Builder.GetInsertBlock();
+  rhs_block = Builder().GetInsertBlock();
   EmitBranch(end_block);
 
   EmitBlock(end_block);
@@ -206,7 +207,7 @@ void CodeGen::Visit(const ConditionOpExpr *node) {
 
   TryEmitLocation(node);
 
-  auto phi{Builder.CreatePHI(lhs->getType(), 2)};
+  auto phi{Builder().CreatePHI(lhs->getType(), 2)};
   phi->addIncoming(lhs, lhs_block);
   phi->addIncoming(rhs, rhs_block);
 
@@ -234,11 +235,11 @@ void CodeGen::Visit(const FuncCallExpr *node) {
 
   if (callee->getType()->isPointerTy()) {
     result_ =
-        Builder.CreateCall(llvm::cast<llvm::FunctionType>(
+        Builder().CreateCall(llvm::cast<llvm::FunctionType>(
                                callee->getType()->getPointerElementType()),
                            callee, args);
   } else {
-    result_ = Builder.CreateCall(
+    result_ = Builder().CreateCall(
         llvm::cast<llvm::Function>(callee)->getFunctionType(), callee, args);
   }
 }
@@ -251,7 +252,7 @@ void CodeGen::Visit(const ConstantExpr *node) {
   auto type{node->GetType()->GetLLVMType()};
 
   if (type->isIntegerTy()) {
-    result_ = llvm::ConstantInt::get(Context, node->GetIntegerVal());
+    result_ = llvm::ConstantInt::get(Context(), node->GetIntegerVal());
   } else if (type->isFloatingPointTy()) {
     result_ = llvm::ConstantFP::get(type, node->GetFloatPointVal());
   } else {
@@ -273,14 +274,14 @@ void CodeGen::Visit(const IdentifierExpr *node) {
 
   auto name{node->GetName()};
 
-  auto func{Module->getFunction(name)};
+  auto func{Module().getFunction(name)};
   if (!func) {
     func = llvm::Function::Create(
         llvm::cast<llvm::FunctionType>(type->GetLLVMType()),
         node->GetLinkage() == Linkage::kInternal
             ? llvm::Function::InternalLinkage
             : llvm::Function::ExternalLinkage,
-        name, Module.get());
+        name, &Module());
   }
 
   result_ = func;
@@ -288,7 +289,7 @@ void CodeGen::Visit(const IdentifierExpr *node) {
 
 void CodeGen::Visit(const EnumeratorExpr *node) {
   TryEmitLocation(node);
-  result_ = llvm::ConstantInt::get(Builder.getInt32Ty(), node->GetVal());
+  result_ = llvm::ConstantInt::get(Builder().getInt32Ty(), node->GetVal());
 }
 
 void CodeGen::Visit(const ObjectExpr *node) {
@@ -305,7 +306,7 @@ void CodeGen::Visit(const ObjectExpr *node) {
   if (type->IsArrayTy() || (type->IsStructOrUnionTy() && !load_struct_)) {
     result_ = ptr;
   } else {
-    result_ = Builder.CreateLoad(ptr, is_volatile_);
+    result_ = Builder().CreateLoad(ptr, is_volatile_);
     is_volatile_ = false;
   }
 }
@@ -320,7 +321,7 @@ llvm::Value *CodeGen::IncOrDec(const Expr *expr, bool is_inc, bool is_postfix) {
   auto lhs_ptr{GetPtr(expr)};
 
   TryEmitLocation(expr);
-  llvm::Value *lhs_value{Builder.CreateLoad(lhs_ptr, is_volatile_)};
+  llvm::Value *lhs_value{Builder().CreateLoad(lhs_ptr, is_volatile_)};
 
   if (is_bit_field_) {
     auto size{bit_field_->GetType()->IsCharacterTy() ? 8 : 32};
@@ -340,7 +341,7 @@ llvm::Value *CodeGen::IncOrDec(const Expr *expr, bool is_inc, bool is_postfix) {
   } else if (type->isFloatingPointTy()) {
     one_value = llvm::ConstantFP::get(type, 1.0);
   } else if (type->isPointerTy()) {
-    one_value = Builder.getInt64(1);
+    one_value = Builder().getInt64(1);
   } else {
     assert(false);
   }
@@ -359,12 +360,12 @@ llvm::Value *CodeGen::IncOrDec(const Expr *expr, bool is_inc, bool is_postfix) {
 llvm::Value *CodeGen::NegOp(llvm::Value *value, bool is_unsigned) {
   if (IsIntegerTy(value)) {
     if (is_unsigned) {
-      return Builder.CreateNeg(value);
+      return Builder().CreateNeg(value);
     } else {
-      return Builder.CreateNSWNeg(value);
+      return Builder().CreateNSWNeg(value);
     }
   } else if (IsFloatingPointTy(value)) {
-    return Builder.CreateFNeg(value);
+    return Builder().CreateFNeg(value);
   } else {
     assert(false);
     return nullptr;
@@ -372,8 +373,8 @@ llvm::Value *CodeGen::NegOp(llvm::Value *value, bool is_unsigned) {
 }
 
 llvm::Value *CodeGen::LogicNotOp(llvm::Value *value) {
-  result_ = Builder.CreateNot(CastToBool(value));
-  return Builder.CreateZExt(result_, Builder.getInt32Ty());
+  result_ = Builder().CreateNot(CastToBool(value));
+  return Builder().CreateZExt(result_, Builder().getInt32Ty());
 }
 
 llvm::Value *CodeGen::Deref(const UnaryOpExpr *node) {
@@ -386,10 +387,11 @@ llvm::Value *CodeGen::Deref(const UnaryOpExpr *node) {
     TryEmitLocation(node);
 
     if (IsArrayPointer(lhs->getType())) {
-      result_ = Builder.CreateInBoundsGEP(lhs, {result_, Builder.getInt64(0)});
+      result_ =
+          Builder().CreateInBoundsGEP(lhs, {result_, Builder().getInt64(0)});
     } else {
-      result_ = Builder.CreateInBoundsGEP(lhs, {result_});
-      result_ = Builder.CreateLoad(result_, is_volatile_);
+      result_ = Builder().CreateInBoundsGEP(lhs, {result_});
+      result_ = Builder().CreateLoad(result_, is_volatile_);
       is_volatile_ = false;
     }
   } else if (IsFuncPointer(node->GetExpr()->GetType()->GetLLVMType())) {
@@ -399,7 +401,7 @@ llvm::Value *CodeGen::Deref(const UnaryOpExpr *node) {
     node->GetExpr()->Accept(*this);
     TryEmitLocation(node);
     if (!node->GetType()->IsArrayTy()) {
-      result_ = Builder.CreateLoad(result_, is_volatile_);
+      result_ = Builder().CreateLoad(result_, is_volatile_);
     }
     is_volatile_ = false;
   }
@@ -411,15 +413,15 @@ llvm::Value *CodeGen::AddOp(llvm::Value *lhs, llvm::Value *rhs,
                             bool is_unsigned) {
   if (IsIntegerTy(lhs)) {
     if (is_unsigned) {
-      return Builder.CreateAdd(lhs, rhs);
+      return Builder().CreateAdd(lhs, rhs);
     } else {
-      return Builder.CreateNSWAdd(lhs, rhs);
+      return Builder().CreateNSWAdd(lhs, rhs);
     }
   } else if (IsFloatingPointTy(lhs)) {
-    return Builder.CreateFAdd(lhs, rhs);
+    return Builder().CreateFAdd(lhs, rhs);
   } else if (IsPointerTy(lhs)) {
     // 进行地址计算, 第二个参数是偏移量列表
-    return Builder.CreateInBoundsGEP(lhs, {rhs});
+    return Builder().CreateInBoundsGEP(lhs, {rhs});
   } else {
     assert(false);
     return nullptr;
@@ -430,23 +432,24 @@ llvm::Value *CodeGen::SubOp(llvm::Value *lhs, llvm::Value *rhs,
                             bool is_unsigned) {
   if (IsIntegerTy(lhs)) {
     if (is_unsigned) {
-      return Builder.CreateSub(lhs, rhs);
+      return Builder().CreateSub(lhs, rhs);
     } else {
-      return Builder.CreateNSWSub(lhs, rhs);
+      return Builder().CreateNSWSub(lhs, rhs);
     }
   } else if (IsFloatingPointTy(lhs)) {
-    return Builder.CreateFSub(lhs, rhs);
+    return Builder().CreateFSub(lhs, rhs);
   } else if (IsPointerTy(lhs) && IsIntegerTy(rhs)) {
-    return Builder.CreateInBoundsGEP(lhs, {Builder.CreateNeg(rhs)});
+    return Builder().CreateInBoundsGEP(lhs, {Builder().CreateNeg(rhs)});
   } else if (IsPointerTy(lhs) && IsPointerTy(rhs)) {
     auto type{lhs->getType()->getPointerElementType()};
 
-    lhs = CastTo(lhs, Builder.getInt64Ty(), true);
-    rhs = CastTo(rhs, Builder.getInt64Ty(), true);
+    lhs = CastTo(lhs, Builder().getInt64Ty(), true);
+    rhs = CastTo(rhs, Builder().getInt64Ty(), true);
 
     auto value{SubOp(lhs, rhs, true)};
     return DivOp(
-        value, Builder.getInt64(Module->getDataLayout().getTypeAllocSize(type)),
+        value,
+        Builder().getInt64(Module().getDataLayout().getTypeAllocSize(type)),
         true);
   } else {
     assert(false);
@@ -458,12 +461,12 @@ llvm::Value *CodeGen::MulOp(llvm::Value *lhs, llvm::Value *rhs,
                             bool is_unsigned) {
   if (IsIntegerTy(lhs)) {
     if (is_unsigned) {
-      return Builder.CreateMul(lhs, rhs);
+      return Builder().CreateMul(lhs, rhs);
     } else {
-      return Builder.CreateNSWMul(lhs, rhs);
+      return Builder().CreateNSWMul(lhs, rhs);
     }
   } else if (IsFloatingPointTy(lhs)) {
-    return Builder.CreateFMul(lhs, rhs);
+    return Builder().CreateFMul(lhs, rhs);
   } else {
     assert(false);
     return nullptr;
@@ -474,12 +477,12 @@ llvm::Value *CodeGen::DivOp(llvm::Value *lhs, llvm::Value *rhs,
                             bool is_unsigned) {
   if (IsIntegerTy(lhs)) {
     if (is_unsigned) {
-      return Builder.CreateUDiv(lhs, rhs);
+      return Builder().CreateUDiv(lhs, rhs);
     } else {
-      return Builder.CreateSDiv(lhs, rhs);
+      return Builder().CreateSDiv(lhs, rhs);
     }
   } else if (IsFloatingPointTy(lhs)) {
-    return Builder.CreateFDiv(lhs, rhs);
+    return Builder().CreateFDiv(lhs, rhs);
   } else {
     assert(false);
     return nullptr;
@@ -489,34 +492,34 @@ llvm::Value *CodeGen::DivOp(llvm::Value *lhs, llvm::Value *rhs,
 llvm::Value *CodeGen::ModOp(llvm::Value *lhs, llvm::Value *rhs,
                             bool is_unsigned) {
   if (is_unsigned) {
-    return Builder.CreateURem(lhs, rhs);
+    return Builder().CreateURem(lhs, rhs);
   } else {
-    return Builder.CreateSRem(lhs, rhs);
+    return Builder().CreateSRem(lhs, rhs);
   }
 }
 
 llvm::Value *CodeGen::OrOp(llvm::Value *lhs, llvm::Value *rhs) {
-  return Builder.CreateOr(lhs, rhs);
+  return Builder().CreateOr(lhs, rhs);
 }
 
 llvm::Value *CodeGen::AndOp(llvm::Value *lhs, llvm::Value *rhs) {
-  return Builder.CreateAnd(lhs, rhs);
+  return Builder().CreateAnd(lhs, rhs);
 }
 
 llvm::Value *CodeGen::XorOp(llvm::Value *lhs, llvm::Value *rhs) {
-  return Builder.CreateXor(lhs, rhs);
+  return Builder().CreateXor(lhs, rhs);
 }
 
 llvm::Value *CodeGen::ShlOp(llvm::Value *lhs, llvm::Value *rhs) {
-  return Builder.CreateShl(lhs, rhs);
+  return Builder().CreateShl(lhs, rhs);
 }
 
 llvm::Value *CodeGen::ShrOp(llvm::Value *lhs, llvm::Value *rhs,
                             bool is_unsigned) {
   if (is_unsigned) {
-    return Builder.CreateLShr(lhs, rhs);
+    return Builder().CreateLShr(lhs, rhs);
   } else {
-    return Builder.CreateAShr(lhs, rhs);
+    return Builder().CreateAShr(lhs, rhs);
   }
 }
 
@@ -526,20 +529,20 @@ llvm::Value *CodeGen::LessEqualOp(llvm::Value *lhs, llvm::Value *rhs,
 
   if (IsIntegerTy(lhs)) {
     if (is_unsigned) {
-      value = Builder.CreateICmpULE(lhs, rhs);
+      value = Builder().CreateICmpULE(lhs, rhs);
     } else {
-      value = Builder.CreateICmpSLE(lhs, rhs);
+      value = Builder().CreateICmpSLE(lhs, rhs);
     }
   } else if (IsFloatingPointTy(lhs)) {
-    value = Builder.CreateFCmpOLE(lhs, rhs);
+    value = Builder().CreateFCmpOLE(lhs, rhs);
   } else if (IsPointerTy(lhs)) {
-    value = Builder.CreateICmpULE(lhs, rhs);
+    value = Builder().CreateICmpULE(lhs, rhs);
   } else {
     assert(false);
     return nullptr;
   }
 
-  return Builder.CreateZExt(value, Builder.getInt32Ty());
+  return Builder().CreateZExt(value, Builder().getInt32Ty());
 }
 
 llvm::Value *CodeGen::LessOp(llvm::Value *lhs, llvm::Value *rhs,
@@ -548,20 +551,20 @@ llvm::Value *CodeGen::LessOp(llvm::Value *lhs, llvm::Value *rhs,
 
   if (IsIntegerTy(lhs)) {
     if (is_unsigned) {
-      value = Builder.CreateICmpULT(lhs, rhs);
+      value = Builder().CreateICmpULT(lhs, rhs);
     } else {
-      value = Builder.CreateICmpSLT(lhs, rhs);
+      value = Builder().CreateICmpSLT(lhs, rhs);
     }
   } else if (IsFloatingPointTy(lhs)) {
-    value = Builder.CreateFCmpOLT(lhs, rhs);
+    value = Builder().CreateFCmpOLT(lhs, rhs);
   } else if (IsPointerTy(lhs)) {
-    value = Builder.CreateICmpULT(lhs, rhs);
+    value = Builder().CreateICmpULT(lhs, rhs);
   } else {
     assert(false);
     return nullptr;
   }
 
-  return Builder.CreateZExt(value, Builder.getInt32Ty());
+  return Builder().CreateZExt(value, Builder().getInt32Ty());
 }
 
 llvm::Value *CodeGen::GreaterEqualOp(llvm::Value *lhs, llvm::Value *rhs,
@@ -570,20 +573,20 @@ llvm::Value *CodeGen::GreaterEqualOp(llvm::Value *lhs, llvm::Value *rhs,
 
   if (IsIntegerTy(lhs)) {
     if (is_unsigned) {
-      value = Builder.CreateICmpUGE(lhs, rhs);
+      value = Builder().CreateICmpUGE(lhs, rhs);
     } else {
-      value = Builder.CreateICmpSGE(lhs, rhs);
+      value = Builder().CreateICmpSGE(lhs, rhs);
     }
   } else if (IsFloatingPointTy(lhs)) {
-    value = Builder.CreateFCmpOGE(lhs, rhs);
+    value = Builder().CreateFCmpOGE(lhs, rhs);
   } else if (IsPointerTy(lhs)) {
-    value = Builder.CreateICmpUGE(lhs, rhs);
+    value = Builder().CreateICmpUGE(lhs, rhs);
   } else {
     assert(false);
     return nullptr;
   }
 
-  return Builder.CreateZExt(value, Builder.getInt32Ty());
+  return Builder().CreateZExt(value, Builder().getInt32Ty());
 }
 
 llvm::Value *CodeGen::GreaterOp(llvm::Value *lhs, llvm::Value *rhs,
@@ -592,59 +595,59 @@ llvm::Value *CodeGen::GreaterOp(llvm::Value *lhs, llvm::Value *rhs,
 
   if (IsIntegerTy(lhs)) {
     if (is_unsigned) {
-      value = Builder.CreateICmpUGT(lhs, rhs);
+      value = Builder().CreateICmpUGT(lhs, rhs);
     } else {
-      value = Builder.CreateICmpSGT(lhs, rhs);
+      value = Builder().CreateICmpSGT(lhs, rhs);
     }
   } else if (IsFloatingPointTy(lhs)) {
-    value = Builder.CreateFCmpOGT(lhs, rhs);
+    value = Builder().CreateFCmpOGT(lhs, rhs);
   } else if (IsPointerTy(lhs)) {
-    value = Builder.CreateICmpUGT(lhs, rhs);
+    value = Builder().CreateICmpUGT(lhs, rhs);
   } else {
     assert(false);
     return nullptr;
   }
 
-  return Builder.CreateZExt(value, Builder.getInt32Ty());
+  return Builder().CreateZExt(value, Builder().getInt32Ty());
 }
 
 llvm::Value *CodeGen::EqualOp(llvm::Value *lhs, llvm::Value *rhs) {
   llvm::Value *value{};
 
   if (IsIntegerTy(lhs) || IsPointerTy(lhs)) {
-    value = Builder.CreateICmpEQ(lhs, rhs);
+    value = Builder().CreateICmpEQ(lhs, rhs);
   } else if (IsFloatingPointTy(lhs)) {
-    value = Builder.CreateFCmpOEQ(lhs, rhs);
+    value = Builder().CreateFCmpOEQ(lhs, rhs);
   } else {
     assert(false);
     return nullptr;
   }
 
-  return Builder.CreateZExt(value, Builder.getInt32Ty());
+  return Builder().CreateZExt(value, Builder().getInt32Ty());
 }
 
 llvm::Value *CodeGen::NotEqualOp(llvm::Value *lhs, llvm::Value *rhs) {
   llvm::Value *value{};
 
   if (IsIntegerTy(lhs) || IsPointerTy(lhs)) {
-    value = Builder.CreateICmpNE(lhs, rhs);
+    value = Builder().CreateICmpNE(lhs, rhs);
   } else if (IsFloatingPointTy(lhs)) {
-    value = Builder.CreateFCmpONE(lhs, rhs);
+    value = Builder().CreateFCmpONE(lhs, rhs);
   } else {
     assert(false);
     return nullptr;
   }
 
-  return Builder.CreateZExt(value, Builder.getInt32Ty());
+  return Builder().CreateZExt(value, Builder().getInt32Ty());
 }
 
 llvm::Value *CodeGen::LogicOrOp(const BinaryOpExpr *node) {
   if (auto lhs{CalcConstantExpr{}.Calc(node->GetLHS())}) {
     if (lhs->isZeroValue()) {
       auto rhs{EvaluateExprAsBool(node->GetRHS())};
-      return Builder.CreateZExt(rhs, Builder.getInt32Ty());
+      return Builder().CreateZExt(rhs, Builder().getInt32Ty());
     } else {
-      return Builder.getInt32(1);
+      return Builder().getInt32(1);
     }
   }
 
@@ -652,32 +655,32 @@ llvm::Value *CodeGen::LogicOrOp(const BinaryOpExpr *node) {
   auto end_block{CreateBasicBlock("logic.or.end")};
 
   EmitBranchOnBoolExpr(node->GetLHS(), end_block, rhs_block);
-  auto phi{llvm::PHINode::Create(Builder.getInt1Ty(), 2, "", end_block)};
+  auto phi{llvm::PHINode::Create(Builder().getInt1Ty(), 2, "", end_block)};
 
   // llvm::predecessors 获取 basic block 的所有前驱
   for (const auto &item : llvm::predecessors(end_block)) {
-    phi->addIncoming(Builder.getTrue(), item);
+    phi->addIncoming(Builder().getTrue(), item);
   }
 
   EmitBlock(rhs_block);
   auto rhs_value{EvaluateExprAsBool(node->GetRHS())};
 
-  rhs_block = Builder.GetInsertBlock();
+  rhs_block = Builder().GetInsertBlock();
   EmitBlock(end_block);
 
   TryEmitLocation(node);
   phi->addIncoming(rhs_value, rhs_block);
 
-  return Builder.CreateZExt(phi, Builder.getInt32Ty());
+  return Builder().CreateZExt(phi, Builder().getInt32Ty());
 }
 
 llvm::Value *CodeGen::LogicAndOp(const BinaryOpExpr *node) {
   if (auto lhs{CalcConstantExpr{}.Calc(node->GetLHS())}) {
     if (lhs->isOneValue()) {
       auto rhs{EvaluateExprAsBool(node->GetRHS())};
-      return Builder.CreateZExt(rhs, Builder.getInt32Ty());
+      return Builder().CreateZExt(rhs, Builder().getInt32Ty());
     } else {
-      return Builder.getInt32(0);
+      return Builder().getInt32(0);
     }
   }
 
@@ -685,23 +688,23 @@ llvm::Value *CodeGen::LogicAndOp(const BinaryOpExpr *node) {
   auto end_block{CreateBasicBlock("logic.and.end")};
 
   EmitBranchOnBoolExpr(node->GetLHS(), rhs_block, end_block);
-  auto phi{llvm::PHINode::Create(Builder.getInt1Ty(), 2, "", end_block)};
+  auto phi{llvm::PHINode::Create(Builder().getInt1Ty(), 2, "", end_block)};
 
   for (const auto &item : llvm::predecessors(end_block)) {
-    phi->addIncoming(Builder.getFalse(), item);
+    phi->addIncoming(Builder().getFalse(), item);
   }
 
   EmitBlock(rhs_block);
   auto rhs_value{EvaluateExprAsBool(node->GetRHS())};
 
-  rhs_block = Builder.GetInsertBlock();
+  rhs_block = Builder().GetInsertBlock();
 
   EmitBlock(end_block);
 
   TryEmitLocation(node);
   phi->addIncoming(rhs_value, rhs_block);
 
-  return Builder.CreateZExt(phi, Builder.getInt32Ty());
+  return Builder().CreateZExt(phi, Builder().getInt32Ty());
 }
 
 llvm::Value *CodeGen::AssignOp(const BinaryOpExpr *node) {
@@ -722,7 +725,7 @@ llvm::Value *CodeGen::MemberRef(const BinaryOpExpr *node) {
   auto type{ptr->getType()->getPointerElementType()};
 
   if (is_bit_field_) {
-    result_ = Builder.CreateLoad(ptr, is_volatile_);
+    result_ = Builder().CreateLoad(ptr, is_volatile_);
 
     auto size{bit_field_->GetType()->IsCharacterTy() ? 8 : 32};
 
@@ -736,7 +739,7 @@ llvm::Value *CodeGen::MemberRef(const BinaryOpExpr *node) {
     if (type->isArrayTy() || (type->isStructTy() && !load_struct_)) {
       result_ = ptr;
     } else {
-      result_ = Builder.CreateLoad(ptr, is_volatile_);
+      result_ = Builder().CreateLoad(ptr, is_volatile_);
     }
   }
 
@@ -746,20 +749,20 @@ llvm::Value *CodeGen::MemberRef(const BinaryOpExpr *node) {
 llvm::Value *CodeGen::Assign(llvm::Value *lhs_ptr, llvm::Value *rhs,
                              bool is_unsigned) {
   if (is_bit_field_) {
-    result_ = Builder.CreateLoad(lhs_ptr, is_volatile_);
+    result_ = Builder().CreateLoad(lhs_ptr, is_volatile_);
 
     auto size{bit_field_->GetType()->IsCharacterTy() ? 8 : 32};
     result_ = GetBitField(result_, size, bit_field_->GetBitFieldWidth(),
                           bit_field_->GetBitFieldBegin());
 
-    rhs = Builder.CreateShl(rhs, bit_field_->GetBitFieldBegin());
-    rhs = CastTo(rhs, Builder.getInt32Ty(), is_unsigned);
-    result_ = Builder.CreateOr(result_, rhs);
+    rhs = Builder().CreateShl(rhs, bit_field_->GetBitFieldBegin());
+    rhs = CastTo(rhs, Builder().getInt32Ty(), is_unsigned);
+    result_ = Builder().CreateOr(result_, rhs);
 
-    Builder.CreateStore(result_, lhs_ptr, is_volatile_);
+    Builder().CreateStore(result_, lhs_ptr, is_volatile_);
 
     if (!TestAndClearIgnoreAssignResult()) {
-      result_ = Builder.CreateLoad(lhs_ptr, is_volatile_);
+      result_ = Builder().CreateLoad(lhs_ptr, is_volatile_);
 
       result_ = GetBitFieldValue(result_, size, bit_field_->GetBitFieldWidth(),
                                  bit_field_->GetBitFieldBegin(),
@@ -778,10 +781,10 @@ llvm::Value *CodeGen::Assign(llvm::Value *lhs_ptr, llvm::Value *rhs,
       return lhs_ptr;
     }
   } else {
-    Builder.CreateStore(rhs, lhs_ptr, is_volatile_);
+    Builder().CreateStore(rhs, lhs_ptr, is_volatile_);
 
     if (!TestAndClearIgnoreAssignResult()) {
-      result_ = Builder.CreateLoad(lhs_ptr, is_volatile_);
+      result_ = Builder().CreateLoad(lhs_ptr, is_volatile_);
       is_volatile_ = false;
       return result_;
     } else {
@@ -847,30 +850,23 @@ bool CodeGen::MayCallBuiltinFunc(const FuncCallExpr *node) {
 }
 
 llvm::Value *CodeGen::VaStart(Expr *arg) {
-  static auto func_type{llvm::FunctionType::get(
-      Builder.getVoidTy(), {Builder.getInt8PtrTy()}, false)};
-
-  static auto va_start{llvm::Function::Create(func_type,
-                                              llvm::Function::ExternalLinkage,
-                                              "llvm.va_start", Module.get())};
+  auto va_start{
+      llvm::Intrinsic::getDeclaration(&Module(), llvm::Intrinsic::vastart)};
 
   arg->Accept(*this);
 
-  result_ = Builder.CreateBitCast(result_, Builder.getInt8PtrTy());
-  return Builder.CreateCall(va_start, {result_});
+  result_ = Builder().CreateBitCast(result_, Builder().getInt8PtrTy());
+  return Builder().CreateCall(va_start, {result_});
 }
 
 llvm::Value *CodeGen::VaEnd(Expr *arg) {
-  static auto func_type{llvm::FunctionType::get(
-      Builder.getVoidTy(), {Builder.getInt8PtrTy()}, false)};
-
-  static auto va_end{llvm::Function::Create(
-      func_type, llvm::Function::ExternalLinkage, "llvm.va_end", Module.get())};
+  auto va_end{
+      llvm::Intrinsic::getDeclaration(&Module(), llvm::Intrinsic::vaend)};
 
   arg->Accept(*this);
 
-  result_ = Builder.CreateBitCast(result_, Builder.getInt8PtrTy());
-  return Builder.CreateCall(va_end, {result_});
+  result_ = Builder().CreateBitCast(result_, Builder().getInt8PtrTy());
+  return Builder().CreateCall(va_end, {result_});
 }
 
 llvm::Value *CodeGen::VaArg(Expr *arg, llvm::Type *type) {
@@ -885,51 +881,51 @@ llvm::Value *CodeGen::VaArg(Expr *arg, llvm::Type *type) {
   auto ptr{result_};
 
   if (type->isIntegerTy() || type->isPointerTy()) {
-    offset_ptr = Builder.CreateStructGEP(ptr, 0);
-    offset = Builder.CreateLoad(offset_ptr);
-    result_ = Builder.CreateICmpULE(
-        offset, llvm::ConstantInt::get(Builder.getInt32Ty(), 40));
+    offset_ptr = Builder().CreateStructGEP(ptr, 0);
+    offset = Builder().CreateLoad(offset_ptr);
+    result_ = Builder().CreateICmpULE(
+        offset, llvm::ConstantInt::get(Builder().getInt32Ty(), 40));
   } else if (type->isFloatingPointTy()) {
-    offset_ptr = Builder.CreateStructGEP(ptr, 1);
-    offset = Builder.CreateLoad(offset_ptr);
-    result_ = Builder.CreateICmpULE(
-        offset, llvm::ConstantInt::get(Builder.getInt32Ty(), 160));
+    offset_ptr = Builder().CreateStructGEP(ptr, 1);
+    offset = Builder().CreateLoad(offset_ptr);
+    result_ = Builder().CreateICmpULE(
+        offset, llvm::ConstantInt::get(Builder().getInt32Ty(), 160));
   } else {
     assert(false);
   }
 
-  Builder.CreateCondBr(result_, lhs_block, rhs_block);
+  Builder().CreateCondBr(result_, lhs_block, rhs_block);
 
   EmitBlock(lhs_block);
-  result_ = Builder.CreateStructGEP(ptr, 3);
-  result_ = Builder.CreateLoad(result_);
-  result_ = Builder.CreateGEP(result_, offset);
-  auto result_ptr{Builder.CreateBitCast(result_, type->getPointerTo())};
+  result_ = Builder().CreateStructGEP(ptr, 3);
+  result_ = Builder().CreateLoad(result_);
+  result_ = Builder().CreateGEP(result_, offset);
+  auto result_ptr{Builder().CreateBitCast(result_, type->getPointerTo())};
 
   if (type->isIntegerTy() || type->isPointerTy()) {
-    result_ = Builder.CreateAdd(
-        offset, llvm::ConstantInt::get(Builder.getInt32Ty(), 8));
+    result_ = Builder().CreateAdd(
+        offset, llvm::ConstantInt::get(Builder().getInt32Ty(), 8));
   } else if (type->isFloatingPointTy()) {
-    result_ = Builder.CreateAdd(
-        offset, llvm::ConstantInt::get(Builder.getInt32Ty(), 16));
+    result_ = Builder().CreateAdd(
+        offset, llvm::ConstantInt::get(Builder().getInt32Ty(), 16));
   } else {
     assert(false);
   }
 
-  Builder.CreateStore(result_, offset_ptr);
+  Builder().CreateStore(result_, offset_ptr);
   EmitBranch(end_block);
 
   EmitBlock(rhs_block);
-  auto pp{Builder.CreateStructGEP(ptr, 2)};
-  result_ = Builder.CreateLoad(pp);
-  auto result_ptr2{Builder.CreateBitCast(result_, type->getPointerTo())};
-  result_ = Builder.CreateGEP(result_,
-                              llvm::ConstantInt::get(Builder.getInt32Ty(), 8));
-  Builder.CreateStore(result_, pp);
+  auto pp{Builder().CreateStructGEP(ptr, 2)};
+  result_ = Builder().CreateLoad(pp);
+  auto result_ptr2{Builder().CreateBitCast(result_, type->getPointerTo())};
+  result_ = Builder().CreateGEP(
+      result_, llvm::ConstantInt::get(Builder().getInt32Ty(), 8));
+  Builder().CreateStore(result_, pp);
   EmitBranch(end_block);
 
   EmitBlock(end_block);
-  auto phi{Builder.CreatePHI(type->getPointerTo(), 2)};
+  auto phi{Builder().CreatePHI(type->getPointerTo(), 2)};
   phi->addIncoming(result_ptr, lhs_block);
   phi->addIncoming(result_ptr2, rhs_block);
 
@@ -937,152 +933,113 @@ llvm::Value *CodeGen::VaArg(Expr *arg, llvm::Type *type) {
 }
 
 llvm::Value *CodeGen::VaCopy(Expr *arg, Expr *arg2) {
-  static auto func_type{llvm::FunctionType::get(
-      Builder.getVoidTy(), {Builder.getInt8PtrTy(), Builder.getInt8PtrTy()},
-      false)};
-
-  static auto va_copy{llvm::Function::Create(func_type,
-                                             llvm::Function::ExternalLinkage,
-                                             "llvm.va_copy", Module.get())};
+  auto va_copy{
+      llvm::Intrinsic::getDeclaration(&Module(), llvm::Intrinsic::vacopy)};
 
   arg->Accept(*this);
   auto param{result_};
   arg2->Accept(*this);
   auto param2{result_};
 
-  return Builder.CreateCall(
-      va_copy, {Builder.CreateBitCast(param, Builder.getInt8PtrTy()),
-                Builder.CreateBitCast(param2, Builder.getInt8PtrTy())});
+  return Builder().CreateCall(
+      va_copy, {Builder().CreateBitCast(param, Builder().getInt8PtrTy()),
+                Builder().CreateBitCast(param2, Builder().getInt8PtrTy())});
 }
 
 llvm::Value *CodeGen::SyncSynchronize() {
-  return Builder.CreateFence(llvm::AtomicOrdering::SequentiallyConsistent,
-                             llvm::SyncScope::System);
+  return Builder().CreateFence(llvm::AtomicOrdering::SequentiallyConsistent,
+                               llvm::SyncScope::System);
 }
 
 llvm::Value *CodeGen::Alloc(Expr *arg) {
   arg->Accept(*this);
-  return Builder.CreateAlloca(Builder.getInt8Ty(), result_);
+  return Builder().CreateAlloca(Builder().getInt8Ty(), result_);
 }
 
 llvm::Value *CodeGen::PopCount(Expr *arg) {
-  static auto func_type{llvm::FunctionType::get(Builder.getInt32Ty(),
-                                                {Builder.getInt32Ty()}, false)};
-
-  static auto ctpop_i32{llvm::Function::Create(func_type,
-                                               llvm::Function::ExternalLinkage,
-                                               "llvm.ctpop.i32", Module.get())};
+  auto ctpop_i32{llvm::Intrinsic::getDeclaration(
+      &Module(), llvm::Intrinsic::ctpop, {Builder().getInt32Ty()})};
 
   arg->Accept(*this);
-  return Builder.CreateCall(ctpop_i32, {result_});
+  return Builder().CreateCall(ctpop_i32, {result_});
 }
 
 llvm::Value *CodeGen::Clz(Expr *arg) {
-  static auto func_type{llvm::FunctionType::get(
-      Builder.getInt32Ty(), {Builder.getInt32Ty(), Builder.getInt1Ty()},
-      false)};
-
-  static auto ctlz_i32{llvm::Function::Create(func_type,
-                                              llvm::Function::ExternalLinkage,
-                                              "llvm.ctlz.i32", Module.get())};
+  auto ctlz_i32{llvm::Intrinsic::getDeclaration(
+      &Module(), llvm::Intrinsic::ctlz, {Builder().getInt32Ty()})};
 
   arg->Accept(*this);
-  return Builder.CreateCall(ctlz_i32, {result_, Builder.getTrue()});
+  return Builder().CreateCall(ctlz_i32, {result_, Builder().getTrue()});
 }
 
 llvm::Value *CodeGen::Ctz(Expr *arg) {
-  static auto func_type{llvm::FunctionType::get(
-      Builder.getInt32Ty(), {Builder.getInt32Ty(), Builder.getInt1Ty()},
-      false)};
-
-  static auto cttz_i32{llvm::Function::Create(func_type,
-                                              llvm::Function::ExternalLinkage,
-                                              "llvm.cttz.i32", Module.get())};
+  auto cttz_i32{llvm::Intrinsic::getDeclaration(
+      &Module(), llvm::Intrinsic::cttz, {Builder().getInt32Ty()})};
 
   arg->Accept(*this);
-  return Builder.CreateCall(cttz_i32, {result_, Builder.getTrue()});
+  return Builder().CreateCall(cttz_i32, {result_, Builder().getTrue()});
 }
 
 llvm::Value *CodeGen::IsInfSign(Expr *arg) {
-  static auto func_type{llvm::FunctionType::get(Builder.getFloatTy(),
-                                                {Builder.getFloatTy()}, false)};
-
-  static auto fabs_f32{llvm::Function::Create(func_type,
-                                              llvm::Function::ExternalLinkage,
-                                              "llvm.fabs.f32", Module.get())};
+  auto fabs_f32{llvm::Intrinsic::getDeclaration(
+      &Module(), llvm::Intrinsic::fabs, {Builder().getFloatTy()})};
 
   arg->Accept(*this);
   auto load{result_};
-  result_ = Builder.CreateCall(fabs_f32, {result_});
+  result_ = Builder().CreateCall(fabs_f32, {result_});
 
-  auto mark{Builder.CreateFCmpOEQ(
+  auto mark{Builder().CreateFCmpOEQ(
       result_,
-      llvm::ConstantFP::get(
-          Builder.getFloatTy(),
-          llvm::APFloat::getInf(GetFloatTypeSemantics(Builder.getFloatTy()))))};
+      llvm::ConstantFP::get(Builder().getFloatTy(),
+                            llvm::APFloat::getInf(GetFloatTypeSemantics(
+                                Builder().getFloatTy()))))};
 
-  result_ = Builder.CreateBitCast(load, Builder.getInt32Ty());
-  result_ = Builder.CreateICmpSLT(result_, Builder.getInt32(0));
-  result_ =
-      Builder.CreateSelect(result_, Builder.getInt32(-1), Builder.getInt32(1));
+  result_ = Builder().CreateBitCast(load, Builder().getInt32Ty());
+  result_ = Builder().CreateICmpSLT(result_, Builder().getInt32(0));
+  result_ = Builder().CreateSelect(result_, Builder().getInt32(-1),
+                                   Builder().getInt32(1));
 
-  return Builder.CreateSelect(mark, result_, Builder.getInt32(0));
+  return Builder().CreateSelect(mark, result_, Builder().getInt32(0));
 }
 
 llvm::Value *CodeGen::IsFinite(Expr *arg) {
-  static auto func_type{llvm::FunctionType::get(Builder.getFloatTy(),
-                                                {Builder.getFloatTy()}, false)};
-
-  static auto fabs_f32{llvm::Function::Create(func_type,
-                                              llvm::Function::ExternalLinkage,
-                                              "llvm.fabs.f32", Module.get())};
+  auto fabs_f32{llvm::Intrinsic::getDeclaration(
+      &Module(), llvm::Intrinsic::fabs, {Builder().getFloatTy()})};
 
   arg->Accept(*this);
-  result_ = Builder.CreateCall(fabs_f32, {result_});
+  result_ = Builder().CreateCall(fabs_f32, {result_});
 
-  result_ = Builder.CreateFCmpONE(
+  result_ = Builder().CreateFCmpONE(
       result_,
-      llvm::ConstantFP::get(
-          Builder.getFloatTy(),
-          llvm::APFloat::getInf(GetFloatTypeSemantics(Builder.getFloatTy()))));
+      llvm::ConstantFP::get(Builder().getFloatTy(),
+                            llvm::APFloat::getInf(GetFloatTypeSemantics(
+                                Builder().getFloatTy()))));
 
-  return Builder.CreateZExt(result_, Builder.getInt32Ty());
+  return Builder().CreateZExt(result_, Builder().getInt32Ty());
 }
 
 llvm::Value *CodeGen::Bswap16(Expr *arg) {
-  static auto func_type{llvm::FunctionType::get(Builder.getInt16Ty(),
-                                                {Builder.getInt16Ty()}, false)};
-
-  static auto bswap_i16{llvm::Function::Create(func_type,
-                                               llvm::Function::ExternalLinkage,
-                                               "llvm.bswap.i16", Module.get())};
+  auto bswap_i16{llvm::Intrinsic::getDeclaration(
+      &Module(), llvm::Intrinsic::bswap, {Builder().getInt16Ty()})};
 
   arg->Accept(*this);
-  return Builder.CreateCall(bswap_i16, {result_});
+  return Builder().CreateCall(bswap_i16, {result_});
 }
 
 llvm::Value *CodeGen::Bswap32(Expr *arg) {
-  static auto func_type{llvm::FunctionType::get(Builder.getInt32Ty(),
-                                                {Builder.getInt32Ty()}, false)};
-
-  static auto bswap_i32{llvm::Function::Create(func_type,
-                                               llvm::Function::ExternalLinkage,
-                                               "llvm.bswap.i32", Module.get())};
+  auto bswap_i32{llvm::Intrinsic::getDeclaration(
+      &Module(), llvm::Intrinsic::bswap, {Builder().getInt32Ty()})};
 
   arg->Accept(*this);
-  return Builder.CreateCall(bswap_i32, {result_});
+  return Builder().CreateCall(bswap_i32, {result_});
 }
 
 llvm::Value *CodeGen::Bswap64(Expr *arg) {
-  static auto func_type{llvm::FunctionType::get(Builder.getInt64Ty(),
-                                                {Builder.getInt64Ty()}, false)};
-
-  static auto bswap_i64{llvm::Function::Create(func_type,
-                                               llvm::Function::ExternalLinkage,
-                                               "llvm.bswap.i64", Module.get())};
+  auto bswap_i64{llvm::Intrinsic::getDeclaration(
+      &Module(), llvm::Intrinsic::bswap, {Builder().getInt64Ty()})};
 
   arg->Accept(*this);
-  return Builder.CreateCall(bswap_i64, {result_});
+  return Builder().CreateCall(bswap_i64, {result_});
 }
 
 }  // namespace kcc
@@ -36,7 +36,7 @@ void CodeGen::Visit(const CaseStmt *node) {
   }
 
   for (auto i{begin}; i <= end; ++i) {
-    switch_inst_->addCase(llvm::ConstantInt::get(Builder.getInt64Ty(), i),
+    switch_inst_->addCase(llvm::ConstantInt::get(Builder().getInt64Ty(), i),
                           block);
   }
 
@@ -120,9 +120,9 @@ void CodeGen::Visit(const SwitchStmt *node) {
 
   auto default_block{CreateBasicBlock("switch.default")};
   auto end_block{CreateBasicBlock("switch.end")};
-  switch_inst_ = Builder.CreateSwitch(cond_val, default_block);
+  switch_inst_ = Builder().CreateSwitch(cond_val, default_block);
 
-  Builder.ClearInsertionPoint();
+  Builder().ClearInsertionPoint();
 
   llvm::BasicBlock *continue_block{};
   if (!std::empty(break_continue_stack_)) {
@@ -163,7 +163,7 @@ void CodeGen::Visit(const WhileStmt *node) {
     }
   }
   if (emit_br) {
-    Builder.CreateCondBr(cond_val, body_block, end_block);
+    Builder().CreateCondBr(cond_val, body_block, end_block);
   }
 
   EmitBlock(body_block);
@@ -209,7 +209,7 @@ void CodeGen::Visit(const DoWhileStmt *node) {
     }
   }
   if (emit_br) {
-    Builder.CreateCondBr(cond_val, body_block, end_block);
+    Builder().CreateCondBr(cond_val, body_block, end_block);
   }
 
   EmitBlock(end_block);
@@ -299,7 +299,7 @@ void CodeGen::Visit(const ReturnStmt *node) {
     Load_Struct_Obj();
     node->GetExpr()->Accept(*this);
     Finish_Load();
-    Builder.CreateStore(result_, return_value_);
+    Builder().CreateStore(result_, return_value_);
   } else {
     Error(node->GetLoc(), "void function '{}' should not return a value",
           func_->getName().str());
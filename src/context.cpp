@@ -0,0 +1,54 @@
+//
+// Created by kaiser on 2026/10/16.
+//
+
+#include "context.h"
+
+#include <clang/Basic/LangOptions.h>
+#include <clang/Basic/LangStandard.h>
+#include <clang/Basic/TargetOptions.h>
+#include <clang/Frontend/FrontendOptions.h>
+#include <llvm/Support/CodeGen.h>
+#include <llvm/Support/Host.h>
+
+#include "llvm_common.h"
+
+namespace kcc {
+
+CompilationContext::CompilationContext() {
+  ci.createDiagnostics();
+
+  auto pto{std::make_shared<clang::TargetOptions>()};
+  auto target_triple{llvm::sys::getDefaultTargetTriple()};
+  pto->Triple = target_triple;
+
+  target_info = clang::TargetInfo::CreateTargetInfo(ci.getDiagnostics(), pto);
+
+  ci.setTarget(target_info);
+  ci.getInvocation().setLangDefaults(
+      ci.getLangOpts(), clang::InputKind{clang::Language::C},
+      target_info->getTriple(), ci.getPreprocessorOpts(),
+      clang::LangStandard::lang_c17);
+
+  auto &lang_opt{ci.getLangOpts()};
+  lang_opt.C17 = true;
+  lang_opt.Digraphs = true;
+  lang_opt.Trigraphs = true;
+  lang_opt.GNUMode = true;
+  lang_opt.GNUKeywords = true;
+
+  module = std::make_unique<llvm::Module>("", context);
+  module->addModuleFlag(llvm::Module::Error, "wchar_size", 4);
+  module->addModuleFlag(llvm::Module::Max, "PIC Level", llvm::PICLevel::BigPIC);
+  module->addModuleFlag(llvm::Module::Max, "PIE Level", llvm::PIELevel::Large);
+
+  target_machine = CreateTargetMachine();
+
+  // 配置模块以指定目标机器和数据布局
+  module->setTargetTriple(target_triple);
+  module->setDataLayout(target_machine->createDataLayout());
+}
+
+Arena &AstArena() { return GetContext().ast_arena; }
+
+}  // namespace kcc
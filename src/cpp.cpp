@@ -4,24 +4,185 @@
 
 #include "cpp.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <filesystem>
+#include <iterator>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
 
 #include <clang/Basic/SourceLocation.h>
 #include <clang/Basic/SourceManager.h>
+#include <clang/Basic/SourceManagerInternals.h>
+#include <clang/Basic/TokenKinds.h>
 #include <clang/Frontend/PreprocessorOutputOptions.h>
 #include <clang/Frontend/Utils.h>
 #include <clang/Lex/DirectoryLookup.h>
+#include <clang/Lex/MacroInfo.h>
 #include <fmt/format.h>
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/SHA1.h>
 #include <llvm/Support/raw_ostream.h>
 
 #include "error.h"
 #include "llvm_common.h"
+#include "util.h"
 
 namespace kcc {
 
+namespace {
+
+// 与 Scanner::SkipNumber 的判断相同
+Tag NumberTag(std::string_view str) {
+  bool saw_hex_prefix{false};
+
+  for (auto ch : str) {
+    if (ch == 'x' || ch == 'X') {
+      saw_hex_prefix = true;
+    } else if (ch == '.') {
+      return Tag::kFloatingPoint;
+    } else if ((ch == 'e' || ch == 'E') && !saw_hex_prefix) {
+      return Tag::kFloatingPoint;
+    } else if ((ch == 'p' || ch == 'P') && saw_hex_prefix) {
+      return Tag::kFloatingPoint;
+    }
+  }
+
+  return Tag::kInteger;
+}
+
+Tag ToTag(const clang::Token &tok, std::string_view spelling) {
+  switch (tok.getKind()) {
+    case clang::tok::l_square:
+      return Tag::kLeftSquare;
+    case clang::tok::r_square:
+      return Tag::kRightSquare;
+    case clang::tok::l_paren:
+      return Tag::kLeftParen;
+    case clang::tok::r_paren:
+      return Tag::kRightParen;
+    case clang::tok::l_brace:
+      return Tag::kLeftBrace;
+    case clang::tok::r_brace:
+      return Tag::kRightBrace;
+    case clang::tok::period:
+      return Tag::kPeriod;
+    case clang::tok::ellipsis:
+      return Tag::kEllipsis;
+    case clang::tok::amp:
+      return Tag::kAmp;
+    case clang::tok::ampamp:
+      return Tag::kAmpAmp;
+    case clang::tok::ampequal:
+      return Tag::kAmpEqual;
+    case clang::tok::star:
+      return Tag::kStar;
+    case clang::tok::starequal:
+      return Tag::kStarEqual;
+    case clang::tok::plus:
+      return Tag::kPlus;
+    case clang::tok::plusplus:
+      return Tag::kPlusPlus;
+    case clang::tok::plusequal:
+      return Tag::kPlusEqual;
+    case clang::tok::minus:
+      return Tag::kMinus;
+    case clang::tok::arrow:
+      return Tag::kArrow;
+    case clang::tok::minusminus:
+      return Tag::kMinusMinus;
+    case clang::tok::minusequal:
+      return Tag::kMinusEqual;
+    case clang::tok::tilde:
+      return Tag::kTilde;
+    case clang::tok::exclaim:
+      return Tag::kExclaim;
+    case clang::tok::exclaimequal:
+      return Tag::kExclaimEqual;
+    case clang::tok::slash:
+      return Tag::kSlash;
+    case clang::tok::slashequal:
+      return Tag::kSlashEqual;
+    case clang::tok::percent:
+      return Tag::kPercent;
+    case clang::tok::percentequal:
+      return Tag::kPercentEqual;
+    case clang::tok::less:
+      return Tag::kLess;
+    case clang::tok::lessless:
+      return Tag::kLessLess;
+    case clang::tok::lessequal:
+      return Tag::kLessEqual;
+    case clang::tok::lesslessequal:
+      return Tag::kLessLessEqual;
+    case clang::tok::greater:
+      return Tag::kGreater;
+    case clang::tok::greatergreater:
+      return Tag::kGreaterGreater;
+    case clang::tok::greaterequal:
+      return Tag::kGreaterEqual;
+    case clang::tok::greatergreaterequal:
+      return Tag::kGreaterGreaterEqual;
+    case clang::tok::caret:
+      return Tag::kCaret;
+    case clang::tok::caretequal:
+      return Tag::kCaretEqual;
+    case clang::tok::pipe:
+      return Tag::kPipe;
+    case clang::tok::pipepipe:
+      return Tag::kPipePipe;
+    case clang::tok::pipeequal:
+      return Tag::kPipeEqual;
+    case clang::tok::question:
+      return Tag::kQuestion;
+    case clang::tok::colon:
+      return Tag::kColon;
+    case clang::tok::semi:
+      return Tag::kSemicolon;
+    case clang::tok::equal:
+      return Tag::kEqual;
+    case clang::tok::equalequal:
+      return Tag::kEqualEqual;
+    case clang::tok::comma:
+      return Tag::kComma;
+    case clang::tok::hash:
+      return Tag::kSharp;
+    case clang::tok::hashhash:
+      return Tag::kSharpSharp;
+    case clang::tok::numeric_constant:
+      return NumberTag(spelling);
+    case clang::tok::char_constant:
+    case clang::tok::wide_char_constant:
+    case clang::tok::utf8_char_constant:
+    case clang::tok::utf16_char_constant:
+    case clang::tok::utf32_char_constant:
+      return Tag::kCharacter;
+    case clang::tok::string_literal:
+    case clang::tok::wide_string_literal:
+    case clang::tok::utf8_string_literal:
+    case clang::tok::utf16_string_literal:
+    case clang::tok::utf32_string_literal:
+      return Tag::kStringLiteral;
+    default:
+      return Tag::kNone;
+  }
+}
+
+}  // namespace
+
 Preprocessor::Preprocessor() {
-  pp_ = &Ci.getPreprocessor();
+  // 只有需要预处理时才创建, 链接时优化等不需要它们
+  Ci().createFileManager(GetHeaderCache());
+  Ci().createSourceManager(Ci().getFileManager());
+  Ci().createPreprocessor(clang::TranslationUnitKind::TU_Complete);
+
+  pp_ = &Ci().getPreprocessor();
   header_search_ = &pp_->getHeaderSearchInfo();
+  header_guards_ = std::make_unique<HeaderGuardSource>(*pp_);
+  header_search_->SetExternalSource(header_guards_.get());
 
   AddIncludePath("/usr/include", true);
   AddIncludePath("/usr/local/include", true);
@@ -74,13 +235,14 @@ void Preprocessor::AddMacroDefinitions(
 }
 
 std::string Preprocessor::Cpp(const std::string &input_file) {
-  Module->setSourceFileName(input_file);
-
-  auto file{Ci.getFileManager().getFileRef(input_file).get()};
-  Ci.getSourceManager().setMainFileID(Ci.getSourceManager().createFileID(
-      file, clang::SourceLocation(), clang::SrcMgr::C_User));
+  // 输出预处理后的代码时包含原来的头文件
+  if (pch_) {
+    pp_->setPredefines(pp_->getPredefines() +
+                       fmt::format(FMT_STRING("#include \"{}\"\n"),
+                                   pch_->header));
+  }
 
-  Ci.getDiagnosticClient().BeginSourceFile(Ci.getLangOpts(), pp_);
+  EnterMainFile(input_file);
 
   std::string code;
   code.reserve(Preprocessor::StrReserve);
@@ -92,29 +254,358 @@ std::string Preprocessor::Cpp(const std::string &input_file) {
   clang::DoPrintPreprocessedInput(*pp_, &os, opts);
   os.flush();
 
-  if (Ci.getDiagnostics().hasErrorOccurred()) {
+  if (Ci().getDiagnostics().hasErrorOccurred()) {
     Error("Preprocess failure");
   }
 
-  Ci.getDiagnosticClient().EndSourceFile();
+  SaveHeaderGuards(*header_search_);
+  Ci().getDiagnosticClient().EndSourceFile();
 
   return code;
 }
 
+std::vector<Token> Preprocessor::Tokenize(const std::string &input_file) {
+  std::vector<Token> tokens;
+  tokens.reserve(Preprocessor::TokenReserve);
+
+  // 预编译头文件中的记号位于翻译单元之前, 其中的宏定义也先于翻译单元,
+  // 翻译单元中再次包含该头文件时直接跳过
+  if (pch_) {
+    tokens = pch_->GetTokens();
+    pp_->setPredefines(pp_->getPredefines() + pch_->macros);
+
+    if (auto file{Ci().getFileManager().getFile(pch_->header)}) {
+      header_search_->MarkFileIncludeOnce(*file);
+    }
+  }
+
+  EnterMainFile(input_file);
+  pp_->EnterMainSourceFile();
+
+  clang::Token tok;
+  do {
+    pp_->Lex(tok);
+    tokens.push_back(ToToken(tok));
+  } while (tok.isNot(clang::tok::eof));
+
+  if (Ci().getDiagnostics().hasErrorOccurred()) {
+    Error("Preprocess failure");
+  }
+
+  AddLineMarkers();
+
+  SaveHeaderGuards(*header_search_);
+  Ci().getDiagnosticClient().EndSourceFile();
+
+  return tokens;
+}
+
+void Preprocessor::EmitPch(const std::string &header,
+                           const std::string &pch_file) {
+  EnterMainFile(header);
+  pp_->EnterMainSourceFile();
+
+  PchFile pch;
+  pch.header = std::filesystem::absolute(header).string();
+  pch.options = GetOptionsHash();
+
+  std::vector<Token> tokens;
+  clang::Token tok;
+  for (pp_->Lex(tok); tok.isNot(clang::tok::eof); pp_->Lex(tok)) {
+    tokens.push_back(ToToken(tok));
+  }
+
+  if (Ci().getDiagnostics().hasErrorOccurred()) {
+    Error("Preprocess failure");
+  }
+
+  AddLineMarkers();
+
+  // 文件表中的下标 -> 在 PchFile::contents 中的下标
+  std::unordered_map<std::size_t, std::uint32_t> files;
+  std::unordered_map<std::string, std::uint32_t> names;
+
+  for (const auto &token : tokens) {
+    auto [index, offset]{DecomposeLocation(token.GetLoc())};
+
+    auto [iter, inserted]{files.try_emplace(index, std::size(pch.contents))};
+    if (inserted) {
+      const auto &file{GetSourceFile(index)};
+      pch.contents.emplace_back(file.content);
+
+      for (const auto &marker : file.markers) {
+        const auto &name{marker.file_name.GetName()};
+        auto [name_iter, name_inserted]{
+            names.try_emplace(name, std::size(pch.names))};
+        if (name_inserted) {
+          pch.names.push_back(name);
+        }
+
+        pch.markers.push_back(
+            {iter->second, marker.offset, name_iter->second, marker.row});
+      }
+    }
+
+    pch.tokens.push_back(
+        {token.GetTag(), std::string{token.GetStr()}, iter->second, offset});
+  }
+
+  // 内置的宏和命令行中定义的宏由使用预编译头文件的翻译单元自己定义,
+  // 但头文件中对它们的 #undef 和重新定义需要记录下来
+  auto &source_manager{Ci().getSourceManager()};
+  for (const auto &item : pp_->macros()) {
+    auto directive{pp_->getLocalMacroDirective(item.first)};
+    if (directive == nullptr) {
+      continue;
+    }
+
+    if (!directive->isDefined()) {
+      pch.macros += "#undef " + item.first->getName().str() + '\n';
+      continue;
+    }
+
+    auto info{pp_->getMacroInfo(item.first)};
+    if (info == nullptr || info->isBuiltinMacro() ||
+        source_manager.isWrittenInBuiltinFile(info->getDefinitionLoc()) ||
+        source_manager.isWrittenInCommandLineFile(info->getDefinitionLoc())) {
+      continue;
+    }
+
+    if (directive->getPrevious() != nullptr) {
+      pch.macros += "#undef " + item.first->getName().str() + '\n';
+    }
+    pch.macros += MacroToString(item.first, *info);
+  }
+
+  // 记录读取过的每个文件, 包括没有产生记号的文件
+  std::vector<std::string> dependencies{pch.header};
+  for (auto iter{source_manager.fileinfo_begin()};
+       iter != source_manager.fileinfo_end(); ++iter) {
+    dependencies.push_back(
+        std::filesystem::absolute(iter->first->getName().str()).string());
+  }
+  for (const auto &name : pch.names) {
+    if (std::filesystem::is_regular_file(name)) {
+      dependencies.push_back(std::filesystem::absolute(name).string());
+    }
+  }
+
+  std::sort(std::begin(dependencies), std::end(dependencies));
+  dependencies.erase(
+      std::unique(std::begin(dependencies), std::end(dependencies)),
+      std::end(dependencies));
+  for (const auto &name : dependencies) {
+    pch.dependencies.push_back(
+        {name, std::filesystem::file_size(name),
+         std::filesystem::last_write_time(name).time_since_epoch().count()});
+  }
+
+  SaveHeaderGuards(*header_search_);
+  Ci().getDiagnosticClient().EndSourceFile();
+
+  pch.Write(pch_file);
+}
+
+void Preprocessor::IncludePch(const std::string &pch_file) {
+  pch_.emplace();
+  pch_->Read(pch_file);
+
+  // 过期时退回到正常地预处理该头文件
+  if (!pch_->IsUpToDate(GetOptionsHash())) {
+    Warning(
+        "precompiled header '{}' is out of date or was built with different "
+        "options, preprocess '{}' instead",
+        pch_file, pch_->header);
+    pp_->setPredefines(pp_->getPredefines() +
+                       fmt::format(FMT_STRING("#include \"{}\"\n"),
+                                   pch_->header));
+    pch_.reset();
+  }
+}
+
+std::string Preprocessor::GetOptionsHash() const {
+  llvm::SHA1 hasher;
+
+  // 预定义的宏中包括 -D 定义的宏
+  for (const auto &item :
+       {std::to_string(static_cast<std::int32_t>(LangStd.getValue())),
+        include_paths_, pp_->getPredefines()}) {
+    hasher.update(item);
+    hasher.update(llvm::StringRef{"", 1});
+  }
+
+  return llvm::toHex(hasher.final(), true);
+}
+
+void Preprocessor::EnterMainFile(const std::string &input_file) {
+  Module().setSourceFileName(input_file);
+
+  if (input_file == "-") {
+    auto buffer{llvm::MemoryBuffer::getSTDIN()};
+    if (!buffer) {
+      Error("can not read from stdin: {}", buffer.getError().message());
+    }
+    Ci().getSourceManager().setMainFileID(Ci().getSourceManager().createFileID(
+        std::move(*buffer), clang::SrcMgr::C_User));
+  } else {
+    auto file{Ci().getFileManager().getFileRef(input_file).get()};
+    Ci().getSourceManager().setMainFileID(Ci().getSourceManager().createFileID(
+        file, clang::SourceLocation(), clang::SrcMgr::C_User));
+  }
+
+  Ci().getDiagnosticClient().BeginSourceFile(Ci().getLangOpts(), pp_);
+}
+
+Token Preprocessor::ToToken(const clang::Token &tok) {
+  Token token;
+
+  // 宏展开得到的记号使用展开处的位置, 与 -E 输出的位置一致
+  // 没有位置的记号沿用上一个记号的位置
+  if (auto loc{tok.getLocation()}; loc.isValid()) {
+    loc_ = ToLocation(loc);
+  }
+  token.SetLoc(loc_);
+
+  if (tok.is(clang::tok::eof)) {
+    token.SetTag(Tag::kEof);
+    return token;
+  }
+
+  // 关键字也有 IdentifierInfo, 按 kcc 自己的关键字表区分
+  // 标识符的名字保存在 IdentifierTable 中, 其他记号的拼写一般直接
+  // 指向源文件或宏展开的缓冲区, 只有需要清理 (如含有续行) 时才保存一份
+  if (auto info{tok.getIdentifierInfo()}; info != nullptr) {
+    auto name{info->getName()};
+    token.SetTag(Keywords.Find({name.data(), name.size()}));
+
+    // 每个 IdentifierInfo 只查找一次驻留表
+    if (token.IsIdentifier()) {
+      if (info->getFETokenInfo() == nullptr) {
+        info->setFETokenInfo(
+            Symbol{std::string_view{name.data(), name.size()}}
+                .GetOpaqueValue());
+      }
+      token.SetSymbol(Symbol::GetFromOpaqueValue(info->getFETokenInfo()));
+    } else {
+      token.SetStr({name.data(), name.size()});
+    }
+    return token;
+  }
+
+  auto spelling{pp_->getSpelling(tok, spelling_)};
+  if (spelling.data() == spelling_.data()) {
+    spelling = saver_.save(spelling);
+  }
+  token.SetStr({spelling.data(), spelling.size()});
+  token.SetTag(ToTag(tok, token.GetStr()));
+
+  if (token.TagIs(Tag::kNone)) {
+    Error(token, "Invalid input: '{}'", token.GetStr());
+  }
+
+  return token;
+}
+
+// 文件在第一次有记号来自它时才加入文件表
+Location Preprocessor::ToLocation(clang::SourceLocation loc) {
+  auto &source_manager{Ci().getSourceManager()};
+  auto [file_id, offset]{source_manager.getDecomposedExpansionLoc(loc)};
+
+  if (file_id != last_file_id_) {
+    auto [iter, inserted]{files_.try_emplace(file_id.getHashValue())};
+    if (inserted) {
+      auto start{source_manager.getLocForStartOfFile(file_id)};
+      auto name{source_manager.getPresumedLoc(start, false).getFilename()};
+      auto content{source_manager.getBufferData(file_id)};
+      iter->second = AddSourceFile(name, {content.data(), content.size()});
+    }
+
+    last_file_id_ = file_id;
+    last_file_loc_ = iter->second;
+  }
+
+  return last_file_loc_.GetLocWithOffset(offset);
+}
+
+void Preprocessor::AddLineMarkers() {
+  auto &source_manager{Ci().getSourceManager()};
+  if (!source_manager.hasLineTable()) {
+    return;
+  }
+
+  auto &line_table{source_manager.getLineTable()};
+  for (const auto &[file_id, entries] : line_table) {
+    auto iter{files_.find(file_id.getHashValue())};
+    if (iter == std::end(files_)) {
+      continue;
+    }
+
+    for (const auto &entry : entries) {
+      auto loc{iter->second.GetLocWithOffset(entry.FileOffset)};
+      // 没有指定文件名时沿用之前的文件名
+      auto name{entry.FilenameID == -1
+                    ? loc.GetFileName()
+                    : line_table.getFilename(entry.FilenameID).str()};
+      // #line 所在行的下一行的行号为 LineNo
+      AddLineMarker(loc, name, entry.LineNo - 1);
+    }
+  }
+}
+
+std::string Preprocessor::MacroToString(const clang::IdentifierInfo *name,
+                                        const clang::MacroInfo &info) {
+  auto str{"#define " + name->getName().str()};
+
+  if (info.isFunctionLike()) {
+    str += '(';
+    for (auto iter{std::begin(info.params())}; iter != std::end(info.params());
+         ++iter) {
+      if (iter != std::begin(info.params())) {
+        str += ',';
+      }
+
+      if (info.isC99Varargs() && std::next(iter) == std::end(info.params())) {
+        str += "...";
+      } else {
+        str += (*iter)->getName();
+        if (info.isGNUVarargs() &&
+            std::next(iter) == std::end(info.params())) {
+          str += "...";
+        }
+      }
+    }
+    str += ')';
+  }
+
+  for (const auto &tok : info.tokens()) {
+    if (&tok == &info.tokens().front() || tok.hasLeadingSpace()) {
+      str += ' ';
+    }
+    str += pp_->getSpelling(tok);
+  }
+  str += '\n';
+
+  return str;
+}
+
 void Preprocessor::AddIncludePath(const std::string &path, bool is_system) {
   if (!std::filesystem::exists(path)) {
     Error("compiler internal error");
   }
 
+  include_paths_ += is_system ? "-isystem" : "-I";
+  include_paths_ += std::filesystem::absolute(path).string();
+  include_paths_.push_back('\0');
+
   if (is_system) {
     clang::DirectoryLookup directory{
-        Ci.getFileManager().getDirectoryRef(path).get(),
+        Ci().getFileManager().getDirectoryRef(path).get(),
         clang::SrcMgr::C_System, false};
     header_search_->AddSearchPath(directory, true);
   } else {
     clang::DirectoryLookup directory{
-        Ci.getFileManager().getDirectoryRef(path).get(), clang::SrcMgr::C_User,
-        false};
+        Ci().getFileManager().getDirectoryRef(path).get(),
+        clang::SrcMgr::C_User, false};
     header_search_->AddSearchPath(directory, false);
   }
 }
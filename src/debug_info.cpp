@@ -12,7 +12,6 @@
 #include <llvm/IR/DebugLoc.h>
 #include <llvm/IR/Module.h>
 
-#include "scope.h"
 #include "util.h"
 
 namespace kcc {
@@ -20,7 +19,7 @@ namespace kcc {
 DebugInfo::DebugInfo() {
   optimize_ = OptimizationLevel != OptLevel::kO0;
 
-  std::filesystem::path path{Module->getSourceFileName()};
+  std::filesystem::path path{Module().getSourceFileName()};
   file_ = builder_.createFile(path.filename().string(),
                               path.parent_path().string());
 
@@ -29,10 +28,10 @@ DebugInfo::DebugInfo() {
       llvm::DICompileUnit::DebugEmissionKind::FullDebug, 0, true, false,
       llvm::DICompileUnit::DebugNameTableKind::None);
 
-  Module->addModuleFlag(llvm::Module::Warning, "Dwarf Version",
-                        llvm::dwarf::DWARF_VERSION);
-  Module->addModuleFlag(llvm::Module::Warning, "Debug Info Version",
-                        llvm::DEBUG_METADATA_VERSION);
+  Module().addModuleFlag(llvm::Module::Warning, "Dwarf Version",
+                         llvm::dwarf::DWARF_VERSION);
+  Module().addModuleFlag(llvm::Module::Warning, "Debug Info Version",
+                         llvm::DEBUG_METADATA_VERSION);
 }
 
 void DebugInfo::Finalize() {
@@ -45,11 +44,11 @@ void DebugInfo::Finalize() {
 
 void DebugInfo::EmitLocation(const AstNode *node) {
   if (!node) {
-    return Builder.SetCurrentDebugLocation(llvm::DebugLoc{});
+    return Builder().SetCurrentDebugLocation(llvm::DebugLoc{});
   }
 
   auto loc{node->GetLoc()};
-  Builder.SetCurrentDebugLocation(
+  Builder().SetCurrentDebugLocation(
       llvm::DebugLoc::get(loc.GetRow(), loc.GetColumn(), GetScope()));
 }
 
@@ -68,7 +67,7 @@ void DebugInfo::EmitFuncStart(const FuncDef *node) {
 
   lexical_blocks_.push_back(subprogram_);
 
-  auto func{Module->getFunction(func_name)};
+  auto func{Module().getFunction(func_name)};
   assert(func != nullptr);
   func->setSubprogram(subprogram_);
 }
@@ -90,13 +89,13 @@ void DebugInfo::EmitParamVar(const std::string &name, Type *type,
 
   builder_.insertDeclare(ptr, param, builder_.createExpression(),
                          llvm::DebugLoc::get(line_no, 0, subprogram_),
-                         Builder.GetInsertBlock());
+                         Builder().GetInsertBlock());
 }
 
 void DebugInfo::EmitLocalVar(const Declaration *decl) {
   assert(decl && decl->IsObjDecl());
 
-  if (Builder.GetInsertBlock() == nullptr) {
+  if (Builder().GetInsertBlock() == nullptr) {
     return;
   }
 
@@ -112,7 +111,7 @@ void DebugInfo::EmitLocalVar(const Declaration *decl) {
   builder_.insertDeclare(
       ptr, var, builder_.createExpression(),
       llvm::DebugLoc::get(loc.GetRow(), loc.GetColumn(), scope),
-      Builder.GetInsertBlock());
+      Builder().GetInsertBlock());
 }
 
 void DebugInfo::EmitGlobalVar(const Declaration *decl) {
@@ -240,10 +239,10 @@ llvm::DIType *DebugInfo::CreateStructType(Type *type, const Location &loc) {
   type_cache_[type] = fwd_type;
 
   llvm::SmallVector<llvm::Metadata *, 16> ele_types;
-  for (const auto &[name, ident] : *type->StructGetScope()) {
+  for (const auto &[name, ident] : type->StructGetMemberMap()) {
     auto member_type{GetOrCreateType(ident->GetType(), ident->GetLoc())};
 
-    if (std::empty(name)) {
+    if (name.Empty()) {
       continue;
     }
 
@@ -258,8 +257,8 @@ llvm::DIType *DebugInfo::CreateStructType(Type *type, const Location &loc) {
     }
 
     member_type = builder_.createMemberType(
-        scope, name, file_, line, size_in_bit, align_in_bit, offset_in_bit,
-        llvm::DINode::DIFlags::FlagPublic, member_type);
+        scope, name.GetName(), file_, line, size_in_bit, align_in_bit,
+        offset_in_bit, llvm::DINode::DIFlags::FlagPublic, member_type);
 
     ele_types.push_back(member_type);
   }
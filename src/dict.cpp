@@ -4,91 +4,171 @@
 
 #include "dict.h"
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+
 namespace kcc {
 
-KeywordsDictionary::KeywordsDictionary() {
-  keywords_.insert({"auto", Tag::kAuto});
-  keywords_.insert({"break", Tag::kBreak});
-  keywords_.insert({"case", Tag::kCase});
-  keywords_.insert({"char", Tag::kChar});
-  keywords_.insert({"const", Tag::kConst});
-  keywords_.insert({"continue", Tag::kContinue});
-  keywords_.insert({"default", Tag::kDefault});
-  keywords_.insert({"do", Tag::kDo});
-  keywords_.insert({"double", Tag::kDouble});
-  keywords_.insert({"else", Tag::kElse});
-  keywords_.insert({"enum", Tag::kEnum});
-  keywords_.insert({"extern", Tag::kExtern});
-  keywords_.insert({"float", Tag::kFloat});
-  keywords_.insert({"for", Tag::kFor});
-  keywords_.insert({"goto", Tag::kGoto});
-  keywords_.insert({"if", Tag::kIf});
-  keywords_.insert({"inline", Tag::kInline});
-  keywords_.insert({"int", Tag::kInt});
-  keywords_.insert({"long", Tag::kLong});
-  keywords_.insert({"register", Tag::kRegister});
-  keywords_.insert({"restrict", Tag::kRestrict});
-  keywords_.insert({"return", Tag::kReturn});
-  keywords_.insert({"short", Tag::kShort});
-  keywords_.insert({"signed", Tag::kSigned});
-  keywords_.insert({"sizeof", Tag::kSizeof});
-  keywords_.insert({"static", Tag::kStatic});
-  keywords_.insert({"struct", Tag::kStruct});
-  keywords_.insert({"switch", Tag::kSwitch});
-  keywords_.insert({"typedef", Tag::kTypedef});
-  keywords_.insert({"union", Tag::kUnion});
-  keywords_.insert({"unsigned", Tag::kUnsigned});
-  keywords_.insert({"void", Tag::kVoid});
-  keywords_.insert({"volatile", Tag::kVolatile});
-  keywords_.insert({"while", Tag::kWhile});
-  keywords_.insert({"_Alignas", Tag::kAlignas});
-  keywords_.insert({"_Alignof", Tag::kAlignof});
-  keywords_.insert({"_Atomic", Tag::kAtomic});
-  keywords_.insert({"_Bool", Tag::kBool});
-  keywords_.insert({"_Complex", Tag::kComplex});
-  keywords_.insert({"_Generic", Tag::kGeneric});
-  keywords_.insert({"_Imaginary", Tag::kImaginary});
-  keywords_.insert({"_Noreturn", Tag::kNoreturn});
-  keywords_.insert({"_Static_assert", Tag::kStaticAssert});
-  keywords_.insert({"_Thread_local", Tag::kThreadLocal});
-
-  keywords_.insert({"__func__", Tag::kFuncName});
-  keywords_.insert({"__builtin_offsetof", Tag::kOffsetof});
-  keywords_.insert({"__builtin_huge_val", Tag::kHugeVal});
-  keywords_.insert({"__builtin_inff", Tag::kInff});
-
-  // GNU 扩展
-  keywords_.insert({"typeof", Tag::kTypeof});
-  keywords_.insert({"__typeof__", Tag::kTypeof});
-  keywords_.insert({"__attribute__", Tag::kAttribute});
-  keywords_.insert({"__extension__", Tag::kExtension});
-  keywords_.insert({"__FUNCTION__", Tag::kFuncName});
-  keywords_.insert({"__PRETTY_FUNCTION__", Tag::kFuncSignature});
-  keywords_.insert({"_Float32", Tag::kFloat});
-  keywords_.insert({"_Float64", Tag::kDouble});
-  keywords_.insert({"_Float32x", Tag::kDouble});
-  // FIXME
-  keywords_.insert({"_Float64x", Tag::kDouble});
-  keywords_.insert({"_Float128", Tag::kDouble});
-
-  keywords_.insert({"__inline", Tag::kInline});
-  keywords_.insert({"__alignof__", Tag::kAlignof});
-  keywords_.insert({"__inline__", Tag::kInline});
-  keywords_.insert({"__restrict", Tag::kRestrict});
-  keywords_.insert({"__restrict__", Tag::kRestrict});
-  keywords_.insert({"__signed__", Tag::kSigned});
-  keywords_.insert({"__volatile__", Tag::kVolatile});
-  keywords_.insert({"asm", Tag::kAsm});
-  keywords_.insert({"__asm__", Tag::kAsm});
-  keywords_.insert({"__asm", Tag::kAsm});
-
-  // 一个显示表达式类型名称的扩展
-  keywords_.insert({"typeid", Tag::kTypeid});
+namespace {
+
+struct Keyword {
+  std::string_view name;
+  Tag tag;
+};
+
+constexpr Keyword KeywordTable[]{
+    {"auto", Tag::kAuto},
+    {"break", Tag::kBreak},
+    {"case", Tag::kCase},
+    {"char", Tag::kChar},
+    {"const", Tag::kConst},
+    {"continue", Tag::kContinue},
+    {"default", Tag::kDefault},
+    {"do", Tag::kDo},
+    {"double", Tag::kDouble},
+    {"else", Tag::kElse},
+    {"enum", Tag::kEnum},
+    {"extern", Tag::kExtern},
+    {"float", Tag::kFloat},
+    {"for", Tag::kFor},
+    {"goto", Tag::kGoto},
+    {"if", Tag::kIf},
+    {"inline", Tag::kInline},
+    {"int", Tag::kInt},
+    {"long", Tag::kLong},
+    {"register", Tag::kRegister},
+    {"restrict", Tag::kRestrict},
+    {"return", Tag::kReturn},
+    {"short", Tag::kShort},
+    {"signed", Tag::kSigned},
+    {"sizeof", Tag::kSizeof},
+    {"static", Tag::kStatic},
+    {"struct", Tag::kStruct},
+    {"switch", Tag::kSwitch},
+    {"typedef", Tag::kTypedef},
+    {"union", Tag::kUnion},
+    {"unsigned", Tag::kUnsigned},
+    {"void", Tag::kVoid},
+    {"volatile", Tag::kVolatile},
+    {"while", Tag::kWhile},
+    {"_Alignas", Tag::kAlignas},
+    {"_Alignof", Tag::kAlignof},
+    {"_Atomic", Tag::kAtomic},
+    {"_Bool", Tag::kBool},
+    {"_Complex", Tag::kComplex},
+    {"_Generic", Tag::kGeneric},
+    {"_Imaginary", Tag::kImaginary},
+    {"_Noreturn", Tag::kNoreturn},
+    {"_Static_assert", Tag::kStaticAssert},
+    {"_Thread_local", Tag::kThreadLocal},
+
+    {"__func__", Tag::kFuncName},
+    {"__builtin_offsetof", Tag::kOffsetof},
+    {"__builtin_huge_val", Tag::kHugeVal},
+    {"__builtin_inff", Tag::kInff},
+
+    // GNU 扩展
+    {"typeof", Tag::kTypeof},
+    {"__typeof__", Tag::kTypeof},
+    {"__attribute__", Tag::kAttribute},
+    {"__extension__", Tag::kExtension},
+    {"__FUNCTION__", Tag::kFuncName},
+    {"__PRETTY_FUNCTION__", Tag::kFuncSignature},
+    {"_Float32", Tag::kFloat},
+    {"_Float64", Tag::kDouble},
+    {"_Float32x", Tag::kDouble},
+    // FIXME
+    {"_Float64x", Tag::kDouble},
+    {"_Float128", Tag::kDouble},
+
+    {"__inline", Tag::kInline},
+    {"__alignof__", Tag::kAlignof},
+    {"__inline__", Tag::kInline},
+    {"__restrict", Tag::kRestrict},
+    {"__restrict__", Tag::kRestrict},
+    {"__signed__", Tag::kSigned},
+    {"__volatile__", Tag::kVolatile},
+    {"asm", Tag::kAsm},
+    {"__asm__", Tag::kAsm},
+    {"__asm", Tag::kAsm},
+
+    // 一个显示表达式类型名称的扩展
+    {"typeid", Tag::kTypeid},
+};
+
+constexpr std::size_t TableSize{1024};
+constexpr std::uint8_t Empty{std::numeric_limits<std::uint8_t>::max()};
+
+static_assert(std::size(KeywordTable) < Empty);
+
+// FNV-1a, seed 用于寻找没有冲突的哈希函数
+constexpr std::uint32_t Hash(std::string_view name, std::uint32_t seed) {
+  std::uint32_t hash{2166136261U ^ seed};
+  for (auto ch : name) {
+    hash ^= static_cast<std::uint8_t>(ch);
+    hash *= 16777619U;
+  }
+  return hash;
 }
 
-Tag KeywordsDictionary::Find(const std::string &name) const {
-  if (auto iter{keywords_.find(name)}; iter != std::end(keywords_)) {
-    return iter->second;
+struct PerfectHash {
+  std::uint32_t seed{};
+  // 哈希值 -> 在 KeywordTable 中的下标
+  std::array<std::uint8_t, TableSize> slots{};
+  // 用于在计算哈希值之前排除大部分标识符
+  std::size_t min_length{std::numeric_limits<std::size_t>::max()};
+  std::size_t max_length{};
+  std::array<bool, 256> first_chars{};
+};
+
+// 编译期尝试不同的 seed, 直到所有关键字都落在不同的位置
+constexpr PerfectHash BuildPerfectHash() {
+  PerfectHash result;
+
+  for (const auto &[name, tag] : KeywordTable) {
+    result.min_length = std::min(result.min_length, std::size(name));
+    result.max_length = std::max(result.max_length, std::size(name));
+    result.first_chars[static_cast<std::uint8_t>(name.front())] = true;
+  }
+
+  for (;; ++result.seed) {
+    result.slots.fill(Empty);
+
+    bool collision{false};
+    for (std::size_t i{}; i < std::size(KeywordTable) && !collision; ++i) {
+      auto hash{Hash(KeywordTable[i].name, result.seed)};
+      auto &slot{result.slots[hash % TableSize]};
+      if (slot != Empty) {
+        collision = true;
+      } else {
+        slot = static_cast<std::uint8_t>(i);
+      }
+    }
+
+    if (!collision) {
+      return result;
+    }
+  }
+}
+
+constexpr auto Table{BuildPerfectHash()};
+
+}  // namespace
+
+Tag KeywordsDictionary::Find(std::string_view name) const {
+  if (std::size(name) < Table.min_length ||
+      std::size(name) > Table.max_length ||
+      !Table.first_chars[static_cast<std::uint8_t>(name.front())]) {
+    return Tag::kIdentifier;
+  }
+
+  if (auto index{Table.slots[Hash(name, Table.seed) % TableSize]};
+      index != Empty && KeywordTable[index].name == name) {
+    return KeywordTable[index].tag;
   } else {
     return Tag::kIdentifier;
   }
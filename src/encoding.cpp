@@ -6,8 +6,10 @@
 
 #include <cassert>
 #include <cstddef>
+#include <memory>
 #include <stdexcept>
 #include <string>
+#include <unordered_map>
 
 #include <unicode/ucnv.h>
 #include <unicode/unistr.h>
@@ -50,6 +52,9 @@ class Conv {
 
   ~Conv() { ucnv_close(cvt_); }
 
+  Conv(const Conv &) = delete;
+  Conv &operator=(const Conv &) = delete;
+
   UConverter *cvt() { return cvt_; }
 
   std::string go(const UChar *buf, std::size_t length, std::size_t max_size) {
@@ -71,14 +76,27 @@ class Conv {
   UConverter *cvt_;
 };
 
+// 转换器在第一次使用时创建, 之后在当前线程中复用
+// UConverter 不是线程安全的, 因此每个线程各有一份
+Conv &GetConv(const std::string &charset) {
+  thread_local std::unordered_map<std::string, std::unique_ptr<Conv>> convs;
+
+  auto &conv{convs[charset]};
+  if (!conv) {
+    conv = std::make_unique<Conv>(charset);
+  }
+
+  return *conv;
+}
+
 std::string between(const std::string &str, const std::string &from_encoding,
                     const std::string &to_encoding) {
   UErrorCode err{U_ZERO_ERROR};
-  Conv from_conv{from_encoding};
+  auto &from_conv{GetConv(from_encoding)};
   icu::UnicodeString temp(str.c_str(), std::size(str), from_conv.cvt(), err);
   check_and_throw_icu_error(err);
 
-  Conv to_conv{to_encoding};
+  auto &to_conv{GetConv(to_encoding)};
   return to_conv.go(temp.getBuffer(), temp.length(), to_conv.max_char_size());
 }
 
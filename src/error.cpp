@@ -4,10 +4,37 @@
 
 #include "error.h"
 
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
 #include <magic_enum.hpp>
 
+#include "context.h"
+
 namespace kcc {
 
+namespace {
+
+// 不属于任何翻译单元的警告, 如命令行和 jobserver 的警告
+std::mutex DriverWarningsMutex;
+std::vector<PendingWarning> DriverWarnings;
+
+}  // namespace
+
+[[noreturn]] void ExitFailure() {
+  if (CurrentContext != nullptr) {
+    throw CompilationError{};
+  }
+
+  std::fflush(nullptr);
+  std::_Exit(EXIT_FAILURE);
+}
+
 [[noreturn]] void Error(Tag tag, const Token &actual) {
   auto loc{actual.GetLoc()};
   fmt::print(fmt::fg(fmt::terminal_color::red), FMT_STRING("{}: error: "),
@@ -22,7 +49,7 @@ namespace kcc {
              loc.GetPositionArrow());
 
   PrintWarnings();
-  std::exit(EXIT_FAILURE);
+  ExitFailure();
 }
 
 [[noreturn]] void Error(const UnaryOpExpr *unary, std::string_view msg) {
@@ -42,7 +69,7 @@ namespace kcc {
              loc.GetPositionArrow());
 
   PrintWarnings();
-  std::exit(EXIT_FAILURE);
+  ExitFailure();
 }
 
 [[noreturn]] void Error(const BinaryOpExpr *binary, std::string_view msg) {
@@ -64,12 +91,51 @@ namespace kcc {
              loc.GetPositionArrow());
 
   PrintWarnings();
-  std::exit(EXIT_FAILURE);
+  ExitFailure();
+}
+
+void AddWarning(PendingWarning warning) {
+  if (CurrentContext != nullptr) {
+    CurrentContext->warnings.push_back(std::move(warning));
+  } else {
+    std::lock_guard lock{DriverWarningsMutex};
+    DriverWarnings.push_back(std::move(warning));
+  }
 }
 
 void PrintWarnings() {
-  for (const auto &[item, arrow] : WarningStrings) {
-    fmt::print(fmt::fg(fmt::terminal_color::white), FMT_STRING("{}"), item);
+  std::vector<PendingWarning> warnings;
+  if (CurrentContext != nullptr) {
+    warnings = std::exchange(CurrentContext->warnings, {});
+  } else {
+    std::lock_guard lock{DriverWarningsMutex};
+    warnings = std::exchange(DriverWarnings, {});
+  }
+
+  static std::mutex mutex;
+  std::lock_guard lock{mutex};
+
+  // 如同一个头文件被包含多次时, 同样的警告会在同一个位置产生多次
+  std::unordered_set<std::string> printed;
+
+  for (const auto &[loc, format] : warnings) {
+    auto message{format()};
+    std::string str;
+    std::string arrow;
+
+    if (loc.IsValid()) {
+      str = fmt::format(FMT_STRING("{}: warning: {}\n{}"), loc.ToLocStr(),
+                        message, loc.GetLineContent());
+      arrow = loc.GetPositionArrow();
+    } else {
+      str = fmt::format(FMT_STRING("warning: {}\n"), message);
+    }
+
+    if (!printed.insert(str + arrow).second) {
+      continue;
+    }
+
+    fmt::print(fmt::fg(fmt::terminal_color::white), FMT_STRING("{}"), str);
     if (!std::empty(arrow)) {
       fmt::print(fmt::fg(fmt::terminal_color::green), FMT_STRING("{}"), arrow);
     }
@@ -0,0 +1,309 @@
+//
+// Created by kaiser on 2026/10/16.
+//
+
+#include "header_cache.h"
+
+#include <atomic>
+#include <ctime>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <clang/Basic/FileManager.h>
+#include <fmt/format.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Chrono.h>
+#include <llvm/Support/Path.h>
+
+#include "util.h"
+
+namespace kcc {
+
+namespace {
+
+std::atomic<std::uint64_t> StatHits;
+std::atomic<std::uint64_t> StatMisses;
+std::atomic<std::uint64_t> FileHits;
+std::atomic<std::uint64_t> FileMisses;
+std::atomic<std::uint64_t> GuardHits;
+
+struct HeaderGuard {
+  std::string macro;
+  // 记录 guard 时头文件的大小和修改时间, 头文件改变后 guard 不再有效
+  std::uint64_t size;
+  std::time_t mtime;
+};
+
+std::shared_mutex GuardsMutex;
+// 头文件名 -> guard 宏
+std::unordered_map<std::string, HeaderGuard> Guards;
+
+bool SameFile(const llvm::vfs::Status &status, std::uint64_t size,
+              std::time_t mtime) {
+  return status.getSize() == size &&
+         llvm::sys::toTimeT(status.getLastModificationTime()) == mtime;
+}
+
+// 缓存的内容在进程结束前一直存在, 这里只引用它
+class CachedFile : public llvm::vfs::File {
+ public:
+  CachedFile(const llvm::vfs::Status &status, const llvm::MemoryBuffer &buffer)
+      : status_{status}, buffer_{buffer} {}
+
+  llvm::ErrorOr<llvm::vfs::Status> status() override { return status_; }
+
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> getBuffer(
+      const llvm::Twine &name, std::int64_t, bool requires_null_terminator,
+      bool) override {
+    return llvm::MemoryBuffer::getMemBuffer(
+        buffer_.getBuffer(), name.str(), requires_null_terminator);
+  }
+
+  std::error_code close() override { return {}; }
+
+ private:
+  llvm::vfs::Status status_;
+  const llvm::MemoryBuffer &buffer_;
+};
+
+class HeaderCacheFileSystem : public llvm::vfs::ProxyFileSystem {
+ public:
+  HeaderCacheFileSystem() : ProxyFileSystem{llvm::vfs::getRealFileSystem()} {}
+
+  llvm::ErrorOr<llvm::vfs::Status> status(const llvm::Twine &path) override {
+    auto key{path.str()};
+
+    {
+      std::shared_lock lock{mutex_};
+      if (auto iter{stats_.find(key)}; iter != std::end(stats_)) {
+        ++StatHits;
+        return iter->second;
+      }
+    }
+
+    ++StatMisses;
+    auto status{ProxyFileSystem::status(key)};
+
+    std::lock_guard lock{mutex_};
+    return stats_.try_emplace(std::move(key), std::move(status))
+        .first->second;
+  }
+
+  llvm::ErrorOr<std::unique_ptr<llvm::vfs::File>> openFileForRead(
+      const llvm::Twine &path) override {
+    auto key{path.str()};
+
+    // 源文件只会被它自己的翻译单元读取一次, 不需要缓存
+    if (llvm::sys::path::extension(key) == ".c") {
+      return ProxyFileSystem::openFileForRead(key);
+    }
+
+    // 缓存可能来自编译服务器之前的请求, 头文件改变后需要重新读取
+    if (auto status{this->status(key)}) {
+      std::shared_lock lock{mutex_};
+      if (auto iter{files_.find(key)};
+          iter != std::end(files_) &&
+          SameFile(iter->second.first, status->getSize(),
+                   llvm::sys::toTimeT(status->getLastModificationTime()))) {
+        ++FileHits;
+        return std::make_unique<CachedFile>(iter->second.first,
+                                            *iter->second.second);
+      }
+    }
+
+    ++FileMisses;
+    return Read(std::move(key), false);
+  }
+
+  // 编译服务器在父进程中预先读入子进程用过的头文件, 之后 fork 出的子进程
+  // 直接继承. 文件在子进程读取之后又被修改时不读入
+  void Preload(const std::string &name, std::uint64_t size,
+               std::time_t mtime) {
+    {
+      std::shared_lock lock{mutex_};
+      if (auto iter{files_.find(name)};
+          iter != std::end(files_) &&
+          SameFile(iter->second.first, size, mtime)) {
+        return;
+      }
+    }
+
+    if (auto status{ProxyFileSystem::status(name)};
+        status && SameFile(*status, size, mtime)) {
+      Read(name, true);
+    }
+  }
+
+  // 只包括当前进程自己读取的文件, 不包括预先读入的和 fork 时继承的
+  template <typename F>
+  void ForEachReadFile(F &&f) {
+    std::shared_lock lock{mutex_};
+    for (const auto &name : read_) {
+      if (auto iter{files_.find(name)}; iter != std::end(files_)) {
+        f(name, iter->second.first);
+      }
+    }
+  }
+
+ private:
+  llvm::ErrorOr<std::unique_ptr<llvm::vfs::File>> Read(std::string key,
+                                                       bool preload) {
+    auto file{ProxyFileSystem::openFileForRead(key)};
+    if (!file) {
+      return file;
+    }
+
+    auto status{(*file)->status()};
+    if (!status) {
+      return status.getError();
+    }
+
+    // 较大的文件使用 mmap
+    auto buffer{(*file)->getBuffer(key, status->getSize())};
+    if (!buffer) {
+      return buffer.getError();
+    }
+
+    std::lock_guard lock{mutex_};
+    // 被替换的内容可能仍被其他翻译单元引用, 不能释放
+    if (auto iter{files_.find(key)}; iter != std::end(files_)) {
+      retired_.push_back(std::move(iter->second.second));
+      files_.erase(iter);
+    }
+    if (!preload) {
+      read_.insert(key);
+    }
+    auto &item{files_
+                   .try_emplace(std::move(key), *status,
+                                std::shared_ptr<llvm::MemoryBuffer>{
+                                    std::move(*buffer)})
+                   .first->second};
+    return std::make_unique<CachedFile>(item.first, *item.second);
+  }
+
+  std::shared_mutex mutex_;
+  std::unordered_map<std::string, llvm::ErrorOr<llvm::vfs::Status>> stats_;
+  std::unordered_map<std::string,
+                     std::pair<llvm::vfs::Status,
+                               std::shared_ptr<llvm::MemoryBuffer>>>
+      files_;
+  std::vector<std::shared_ptr<llvm::MemoryBuffer>> retired_;
+  std::unordered_set<std::string> read_;
+};
+
+std::string HitRate(std::uint64_t hits, std::uint64_t misses) {
+  return fmt::format(FMT_STRING("{} hits, {} misses ({:.1f}%)"), hits, misses,
+                     hits + misses == 0 ? 0.0
+                                        : 100.0 * hits / (hits + misses));
+}
+
+llvm::IntrusiveRefCntPtr<HeaderCacheFileSystem> GetInstance() {
+  static llvm::IntrusiveRefCntPtr<HeaderCacheFileSystem> header_cache{
+      new HeaderCacheFileSystem};
+  return header_cache;
+}
+
+}  // namespace
+
+llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> GetHeaderCache() {
+  return GetInstance();
+}
+
+void SaveHeaderGuards(const clang::HeaderSearch &header_search) {
+  llvm::SmallVector<const clang::FileEntry *, 64> files;
+  header_search.getFileMgr().GetUniqueIDMapping(files);
+
+  std::lock_guard lock{GuardsMutex};
+  for (const auto &file : files) {
+    if (file == nullptr) {
+      continue;
+    }
+
+    if (auto info{header_search.getExistingFileInfo(file, false)};
+        info != nullptr && info->ControllingMacro != nullptr) {
+      Guards.insert_or_assign(
+          file->getName().str(),
+          HeaderGuard{info->ControllingMacro->getName().str(),
+                      static_cast<std::uint64_t>(file->getSize()),
+                      file->getModificationTime()});
+    }
+  }
+}
+
+HeaderGuardSource::HeaderGuardSource(clang::Preprocessor &preprocessor)
+    : preprocessor_{preprocessor} {}
+
+clang::HeaderFileInfo HeaderGuardSource::GetHeaderFileInfo(
+    const clang::FileEntry *file) {
+  clang::HeaderFileInfo info;
+
+  std::shared_lock lock{GuardsMutex};
+  if (auto iter{Guards.find(file->getName().str())};
+      iter != std::end(Guards) &&
+      static_cast<std::uint64_t>(file->getSize()) == iter->second.size &&
+      file->getModificationTime() == iter->second.mtime) {
+    ++GuardHits;
+    // 只有 External 的信息才会被合并
+    info.External = true;
+    info.ControllingMacro =
+        preprocessor_.getIdentifierInfo(iter->second.macro);
+  }
+
+  return info;
+}
+
+std::vector<CachedHeader> GetCachedHeaders() {
+  std::vector<CachedHeader> headers;
+
+  std::shared_lock lock{GuardsMutex};
+  GetInstance()->ForEachReadFile(
+      [&](const std::string &name, const llvm::vfs::Status &status) {
+        // 相对路径依赖于当前请求的工作目录
+        if (!llvm::sys::path::is_absolute(name)) {
+          return;
+        }
+
+        CachedHeader header{
+            name, status.getSize(),
+            llvm::sys::toTimeT(status.getLastModificationTime()), {}};
+        if (auto iter{Guards.find(name)};
+            iter != std::end(Guards) && iter->second.size == header.size &&
+            iter->second.mtime == header.mtime) {
+          header.guard = iter->second.macro;
+        }
+        headers.push_back(std::move(header));
+      });
+
+  return headers;
+}
+
+void PreloadHeader(const CachedHeader &header) {
+  GetInstance()->Preload(header.name, header.size, header.mtime);
+
+  if (!std::empty(header.guard)) {
+    std::lock_guard lock{GuardsMutex};
+    Guards.insert_or_assign(
+        header.name, HeaderGuard{header.guard, header.size, header.mtime});
+  }
+}
+
+void PrintHeaderCacheStatistics() {
+  if (Timing) {
+    std::cout << "Header cache: stat " << HitRate(StatHits, StatMisses)
+              << ", open " << HitRate(FileHits, FileMisses) << ", "
+              << GuardHits << " include guards reused" << std::endl;
+  }
+}
+
+}  // namespace kcc
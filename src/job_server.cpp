@@ -0,0 +1,143 @@
+//
+// Created by kaiser on 2026/10/16.
+//
+
+#include "job_server.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include "error.h"
+
+namespace kcc {
+
+JobServer::JobServer() {
+  auto make_flags{std::getenv("MAKEFLAGS")};
+  if (make_flags == nullptr) {
+    return;
+  }
+
+  // 可能出现多次, 以最后一次为准
+  std::istringstream iss{make_flags};
+  std::string auth;
+  for (std::string word; iss >> word;) {
+    for (std::string_view prefix : {"--jobserver-auth=", "--jobserver-fds="}) {
+      if (word.starts_with(prefix)) {
+        auth = word.substr(std::size(prefix));
+      }
+    }
+  }
+
+  if (!std::empty(auth)) {
+    Parse(auth);
+  }
+}
+
+JobServer::~JobServer() {
+  if (is_fifo_) {
+    close(read_fd_);
+  }
+}
+
+bool JobServer::IsValid() const { return read_fd_ != -1; }
+
+void JobServer::Acquire() {
+  if (!IsValid()) {
+    return;
+  }
+
+  {
+    std::lock_guard lock{mutex_};
+    if (!implicit_token_used_) {
+      implicit_token_used_ = true;
+      return;
+    }
+  }
+
+  char token;
+  while (true) {
+    if (auto n{read(read_fd_, &token, 1)}; n == 1) {
+      break;
+    } else if (n == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      // 文件描述符可能是非阻塞的
+      pollfd fd{read_fd_, POLLIN, 0};
+      poll(&fd, 1, -1);
+    } else if (n == 0 || errno != EINTR) {
+      Error("can not read from the jobserver");
+    }
+  }
+
+  std::lock_guard lock{mutex_};
+  tokens_.push_back(token);
+}
+
+void JobServer::Release() {
+  if (!IsValid()) {
+    return;
+  }
+
+  std::lock_guard lock{mutex_};
+  if (std::empty(tokens_)) {
+    implicit_token_used_ = false;
+    return;
+  }
+
+  auto token{tokens_.back()};
+  tokens_.pop_back();
+
+  while (write(write_fd_, &token, 1) != 1) {
+    if (errno != EINTR) {
+      Error("can not write to the jobserver");
+    }
+  }
+}
+
+// --jobserver-auth=fifo:PATH (make 4.4 起)
+// --jobserver-auth=R,W
+void JobServer::Parse(const std::string &auth) {
+  if (auth.starts_with("fifo:")) {
+    auto fd{open(auth.substr(5).c_str(), O_RDWR | O_CLOEXEC)};
+    if (fd == -1) {
+      Warning("can not open the jobserver fifo: {}", auth.substr(5));
+      return;
+    }
+
+    read_fd_ = write_fd_ = fd;
+    is_fifo_ = true;
+  } else if (auto pos{auth.find(',')}; pos != std::string::npos) {
+    auto parse{[](std::string_view str, std::int32_t &fd) {
+      auto [ptr, ec]{
+          std::from_chars(str.data(), str.data() + std::size(str), fd)};
+      return ec == std::errc{} && ptr == str.data() + std::size(str);
+    }};
+
+    std::int32_t read_fd{-1};
+    std::int32_t write_fd{-1};
+    std::string_view str{auth};
+
+    // 如果 make 没有把命令行当作递归的 make (缺少 '+'),
+    // 文件描述符不会被继承下来
+    if (!parse(str.substr(0, pos), read_fd) ||
+        !parse(str.substr(pos + 1), write_fd) || read_fd < 0 ||
+        write_fd < 0 || fcntl(read_fd, F_GETFD) == -1 ||
+        fcntl(write_fd, F_GETFD) == -1) {
+      Warning("jobserver unavailable, ignoring --jobserver-auth={}", auth);
+      return;
+    }
+
+    read_fd_ = read_fd;
+    write_fd_ = write_fd;
+  }
+}
+
+}  // namespace kcc
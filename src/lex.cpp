@@ -4,12 +4,14 @@
 
 #include "lex.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cctype>
 
 #include <magic_enum.hpp>
 
 #include "error.h"
+#include "lex_simd.h"
 
 namespace kcc {
 
@@ -32,14 +34,38 @@ std::int32_t CharToDigit(std::int32_t ch) {
 
 }  // namespace
 
-Scanner::Scanner(std::string preprocessed_code)
-    : source_{std::move(preprocessed_code)} {
-  loc_.SetContent(source_.data());
+Scanner::Scanner(std::string_view code) : source_{code} {}
+
+Scanner::Scanner(std::string_view code, const Location &loc)
+    : source_{code}, loc_{loc} {}
+
+void Scanner::Detach() { detached_ = true; }
+
+const Token &Scanner::ScanDetached() {
+  assert(detached_);
+  deferred_ = {};
+
+  try {
+    Scan();
+  } catch (const Deferred &) {
+    Defer();
+    // 之后的内容不再扫描
+    index_ = std::size(source_);
+  }
+
+  if (deferred_.IsValid()) {
+    token_.SetTag(Tag::kNone);
+    token_.SetStr({});
+    token_.SetLoc(deferred_);
+  }
+
+  return token_;
 }
 
-Scanner::Scanner(std::string code, const Location &loc)
-    : source_{std::move(code)} {
-  loc_ = loc;
+const Token &Scanner::Rescan(const Location &loc) {
+  assert(!detached_);
+  index_ = loc.GetOffset() - loc_.GetOffset();
+  return Scan();
 }
 
 std::vector<Token> Scanner::Tokenize() {
@@ -64,7 +90,7 @@ std::string Scanner::HandleIdentifier() {
   std::string ident;
 
   while (HasNext()) {
-    std::int32_t ch{Next(false)};
+    std::int32_t ch{Next()};
     if (IsUCN(ch)) {
       AppendUCN(ident, HandleEscape());
     } else {
@@ -81,10 +107,10 @@ std::pair<std::int32_t, Encoding> Scanner::HandleCharacter() {
   std::int32_t val{};
   std::int32_t count{};
   // eat '
-  Next(false);
+  Next();
 
   while (!Test('\'')) {
-    std::int32_t ch{Next(false)};
+    std::int32_t ch{Next()};
     if (ch == '\\') {
       ch = HandleEscape();
     }
@@ -98,7 +124,7 @@ std::pair<std::int32_t, Encoding> Scanner::HandleCharacter() {
   }
 
   if (count > 1) {
-    Warning(loc_, "multi-character character constant");
+    Warning(GetLoc(), "multi-character character constant");
   }
 
   return {val, encoding};
@@ -109,10 +135,10 @@ std::pair<std::string, Encoding> Scanner::HandleStringLiteral(
   auto encoding{HandleEncoding()};
   std::string str;
   // eat "
-  Next(false);
+  Next();
 
   while (!Test('"')) {
-    std::int32_t ch{Next(false)};
+    std::int32_t ch{Next()};
     bool is_ucn{IsUCN(ch)};
 
     if (handle_escape && ch == '\\') {
@@ -129,44 +155,64 @@ std::pair<std::string, Encoding> Scanner::HandleStringLiteral(
   return {str, encoding};
 }
 
+template <typename... Args>
+void Scanner::Error(const Location &loc, std::string_view format_str,
+                    const Args &...args) {
+  if (detached_) {
+    throw Deferred{};
+  }
+
+  kcc::Error(loc, format_str, args...);
+}
+
+// 警告保存在当前的编译上下文中, 分离的线程没有编译上下文,
+// 同样交给 Rescan 报告
+template <typename... Args>
+void Scanner::Warning(const Location &loc, std::string_view format_str,
+                      const Args &...args) {
+  if (detached_) {
+    Defer();
+    return;
+  }
+
+  kcc::Warning(loc, format_str, args...);
+}
+
+// 从当前记号 (或者之前的行标记) 开始重新扫描
+void Scanner::Defer() {
+  if (!deferred_.IsValid()) {
+    deferred_ = token_.GetLoc();
+  }
+}
+
 bool Scanner::HasNext() { return index_ < std::size(source_); }
 
 std::int32_t Scanner::Peek() {
-  // 注意 C++11 起, 若 curr_index_ == size() 则返回空字符
+  if (!HasNext()) {
+    return '\0';
+  }
+
   auto ret{source_[index_]};
   // 可能是 UTF-8 编码的非 ascii 字符, 此时值为负
   return ret >= 0 ? ret : ret + 256;
 }
 
-std::int32_t Scanner::Next(bool push) {
+std::int32_t Scanner::Next() {
   auto ch{Peek()};
   ++index_;
-
-  if (push) {
-    buffer_.push_back(ch);
-  }
-
-  if (ch == '\n') {
-    loc_.NextRow(index_);
-  } else {
-    loc_.NextColumn();
-  }
-
   return ch;
 }
 
 void Scanner::PutBack() {
   assert(index_ > 0);
-  auto ch{source_[--index_]};
+  --index_;
+}
 
-  assert(!std::empty(buffer_));
-  buffer_.pop_back();
+void Scanner::Skip(std::size_t count) { index_ += count; }
 
-  if (ch == '\n') {
-    loc_.PrevRow();
-  } else {
-    loc_.PrevColumn();
-  }
+std::string_view Scanner::Rest() const {
+  return index_ < std::size(source_) ? source_.substr(index_)
+                                     : std::string_view{};
 }
 
 bool Scanner::Test(std::int32_t c) { return Peek() == c; }
@@ -186,12 +232,19 @@ bool Scanner::IsUCN(std::int32_t ch) {
 
 const Token &Scanner::MakeToken(Tag tag) {
   token_.SetTag(tag);
-  token_.SetStr(buffer_);
-  buffer_.clear();
+  token_.SetStr(source_.substr(begin_, index_ - begin_));
   return token_;
 }
 
-void Scanner::MarkLocation() { token_.SetLoc(loc_); }
+void Scanner::MarkLocation() {
+  token_.SetLoc(GetLoc());
+  begin_ = index_;
+}
+
+// 读到结尾之后 index_ 可能超出 source_ 的范围
+Location Scanner::GetLoc() const {
+  return loc_.GetLocWithOffset(std::min(index_, std::size(source_)));
+}
 
 const Token &Scanner::Scan() {
   SkipSpace();
@@ -360,56 +413,56 @@ const Token &Scanner::Scan() {
       if (Test('u') || Test('U')) {
         return SkipIdentifier();
       } else {
-        Error(loc_, "Invalid input: '{}'", static_cast<char>(ch));
+        Error(GetLoc(), "Invalid input: '{}'", static_cast<char>(ch));
       }
     case '_':
       // 扩展
     case '$':
       return SkipIdentifier();
     case '\0':
-      buffer_.clear();
-      return MakeToken(Tag::kEof);
+      token_.SetTag(Tag::kEof);
+      token_.SetStr({});
+      return token_;
     default: {
       // 字节 0xFE 和 0xFF 在 UTF-8 编码中从未用到
       if (std::isalpha(ch) || (ch >= 0x80 && ch <= 0xfd)) {
         return SkipIdentifier();
       } else {
-        Error(loc_, "Invalid input: '{}'", static_cast<char>(ch));
+        Error(GetLoc(), "Invalid input: '{}'", static_cast<char>(ch));
       }
     }
   }
 }
 
-void Scanner::SkipSpace() {
-  while (std::isspace(Peek())) {
-    Next(false);
-  }
-}
+void Scanner::SkipSpace() { index_ += SpanSpace(Rest()); }
 
 void Scanner::SkipLineDirectives() {
-  // clear '#'
-  buffer_.clear();
+  auto loc{GetLoc()};
   // eat space
-  Next(false);
+  Next();
 
   // eat first number
+  begin_ = index_;
   Next();
   // # 后的数字指示的是下一行的行号
-  loc_.SetRow(std::stoi(SkipNumber().GetStr()) - 1);
+  auto row{std::stoi(std::string{SkipNumber().GetStr()}) - 1};
   // eat space
-  Next(false);
+  Next();
 
   // eat "
+  begin_ = index_;
   Next();
   auto file_name{SkipStringLiteral().GetStr()};
-  // 去掉前后的 "
-  loc_.SetFileName(file_name.substr(1, std::size(file_name) - 2));
+  if (detached_) {
+    Defer();
+  } else {
+    // 去掉前后的 "
+    AddLineMarker(loc, file_name.substr(1, std::size(file_name) - 2), row);
+  }
 
-  while (HasNext() && Next(false) != '\n') {
+  while (HasNext() && Next() != '\n') {
     // 跳过该行后面的所有内容
   }
-
-  buffer_.clear();
 }
 
 // pp-number:
@@ -427,7 +480,7 @@ const Token &Scanner::SkipNumber() {
   auto tag{Tag::kInteger};
 
   // 第一个字符不能是 identifier-nondigit, 并不需要加 256
-  std::int32_t ch{buffer_.front()};
+  std::int32_t ch{source_[begin_]};
   while (ch == '.' || std::isalnum(ch) || ch == '_' || IsUCN(ch) ||
          (ch >= 0x80 && ch <= 0xfd)) {
     // 注意有 e 不一定是浮点数
@@ -452,6 +505,7 @@ const Token &Scanner::SkipNumber() {
       saw_hex_prefix = true;
     }
 
+    Skip(SpanDigit(Rest()));
     ch = Next();
   }
   PutBack();
@@ -476,18 +530,39 @@ const Token &Scanner::SkipNumber() {
 //  0123456789
 const Token &Scanner::SkipIdentifier() {
   PutBack();
-  std::int32_t ch{Next()};
 
-  while (std::isalnum(ch) || ch == '_' || IsUCN(ch) ||
-         (0x80 <= ch && ch <= 0xfd) || ch == '$') {
-    if (IsUCN(ch)) {
+  auto has_ucn{false};
+  while (true) {
+    Skip(SpanIdentifier(Rest()));
+
+    if (Test('\\') && index_ + 1 < std::size(source_) &&
+        (source_[index_ + 1] == 'u' || source_[index_ + 1] == 'U')) {
+      Next();
       HandleEscape();
+      has_ucn = true;
+    } else {
+      break;
     }
-    ch = Next();
   }
-  PutBack();
 
-  return MakeToken(Scanner::Keywords.Find(buffer_));
+  auto str{source_.substr(begin_, index_ - begin_)};
+  if (auto tag{Scanner::Keywords.Find(str)}; tag != Tag::kIdentifier) {
+    return MakeToken(tag);
+  }
+
+  token_.SetTag(Tag::kIdentifier);
+  if (detached_) {
+    if (has_ucn) {
+      Defer();
+    }
+    token_.SetStr(str);
+    return token_;
+  }
+
+  // 含有通用字符名时按转换后的名字驻留
+  token_.SetSymbol(has_ucn ? Symbol{Scanner{str}.HandleIdentifier()}
+                           : Symbol{str});
+  return token_;
 }
 
 // character-constant:
@@ -500,16 +575,18 @@ const Token &Scanner::SkipIdentifier() {
 //  the single-quote ', backslash \, or new-line character
 //  escape-sequence
 const Token &Scanner::SkipCharacter() {
+  Skip(SpanQuoted(Rest(), '\''));
   auto ch{Next()};
   while (ch != '\'' && ch != '\n' && ch != '\0') {
     if (ch == '\\') {
       Next();
     }
+    Skip(SpanQuoted(Rest(), '\''));
     ch = Next();
   }
 
   if (ch != '\'') {
-    Error(loc_, "missing terminating ' character");
+    Error(GetLoc(), "missing terminating ' character");
   }
 
   return MakeToken(Tag::kCharacter);
@@ -527,16 +604,18 @@ const Token &Scanner::SkipCharacter() {
 //  the double-quote ", backslash \, or new-line character
 //  escape-sequence
 const Token &Scanner::SkipStringLiteral() {
+  Skip(SpanQuoted(Rest(), '"'));
   auto ch{Next()};
   while (ch != '\"' && ch != '\n' && ch != '\0') {
     if (ch == '\\') {
       Next();
     }
+    Skip(SpanQuoted(Rest(), '"'));
     ch = Next();
   }
 
   if (ch != '\"') {
-    Error(loc_, "missing terminating \" character");
+    Error(GetLoc(), "missing terminating \" character");
   }
 
   return MakeToken(Tag::kStringLiteral);
@@ -609,7 +688,7 @@ std::int32_t Scanner::HandleEscape() {
     case 'U':
       return HandleUCN(8);
     default: {
-      Error(loc_, "unknown escape sequence '\\{}'", ch);
+      Error(GetLoc(), "unknown escape sequence '\\{}'", ch);
     }
   }
 }
@@ -622,7 +701,7 @@ std::int32_t Scanner::HandleHexEscape() {
   auto ch{Next()};
 
   if (!std::isxdigit(ch)) {
-    Error(loc_, "\\x used with no following hex digits: '{}'", ch);
+    Error(GetLoc(), "\\x used with no following hex digits: '{}'", ch);
   }
 
   while (std::isxdigit(ch)) {
@@ -642,7 +721,7 @@ std::int32_t Scanner::HandleOctEscape(std::int32_t ch) {
   std::int32_t value{CharToDigit(ch)};
 
   if (!IsOctDigit(ch)) {
-    Error(loc_, "\\nnn used with no following oct digits: '{}'", ch);
+    Error(GetLoc(), "\\nnn used with no following oct digits: '{}'", ch);
   }
 
   for (std::int32_t i{0}; i < 3; ++i) {
@@ -670,7 +749,7 @@ std::int32_t Scanner::HandleUCN(std::int32_t length) {
   for (std::int32_t i{0}; i < length; ++i) {
     auto ch{Next()};
     if (!std::isxdigit(ch)) {
-      Error(loc_, "\\u / \\U used with no following hex digits: '{}'", ch);
+      Error(GetLoc(), "\\u / \\U used with no following hex digits: '{}'", ch);
     }
     val = (val << 4) + CharToDigit(ch);
   }
@@ -0,0 +1,181 @@
+//
+// Created by kaiser on 2026/10/16.
+//
+
+#include "lex_simd.h"
+
+#include <bit>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define KCC_SIMD
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define KCC_SIMD
+#endif
+
+namespace kcc {
+
+namespace {
+
+bool IsSpace(char ch) {
+  return ch == ' ' || (ch >= '\t' && ch <= '\r');
+}
+
+bool IsIdentifier(char ch) {
+  auto c{static_cast<unsigned char>(ch)};
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+         (c >= '0' && c <= '9') || c == '_' || c == '$' ||
+         (c >= 0x80 && c <= 0xfd);
+}
+
+bool IsDigit(char ch) { return ch >= '0' && ch <= '9'; }
+
+#ifdef KCC_SIMD
+
+#if defined(__AVX2__)
+using Block = __m256i;
+constexpr std::size_t BlockSize{32};
+constexpr std::uint32_t FullMask{0xffffffff};
+
+Block Load(const char *p) {
+  return _mm256_loadu_si256(reinterpret_cast<const Block *>(p));
+}
+Block Set(char ch) { return _mm256_set1_epi8(ch); }
+Block Eq(Block lhs, Block rhs) { return _mm256_cmpeq_epi8(lhs, rhs); }
+// 有符号比较
+Block Gt(Block lhs, Block rhs) { return _mm256_cmpgt_epi8(lhs, rhs); }
+Block Or(Block lhs, Block rhs) { return _mm256_or_si256(lhs, rhs); }
+Block And(Block lhs, Block rhs) { return _mm256_and_si256(lhs, rhs); }
+std::uint32_t Mask(Block block) {
+  return static_cast<std::uint32_t>(_mm256_movemask_epi8(block));
+}
+#else
+using Block = __m128i;
+constexpr std::size_t BlockSize{16};
+constexpr std::uint32_t FullMask{0xffff};
+
+Block Load(const char *p) {
+  return _mm_loadu_si128(reinterpret_cast<const Block *>(p));
+}
+Block Set(char ch) { return _mm_set1_epi8(ch); }
+Block Eq(Block lhs, Block rhs) { return _mm_cmpeq_epi8(lhs, rhs); }
+// 有符号比较
+Block Gt(Block lhs, Block rhs) { return _mm_cmpgt_epi8(lhs, rhs); }
+Block Or(Block lhs, Block rhs) { return _mm_or_si128(lhs, rhs); }
+Block And(Block lhs, Block rhs) { return _mm_and_si128(lhs, rhs); }
+std::uint32_t Mask(Block block) {
+  return static_cast<std::uint32_t>(_mm_movemask_epi8(block));
+}
+#endif
+
+// [lo, hi], 只用于 ascii 字符
+Block InRange(Block block, char lo, char hi) {
+  return And(Gt(block, Set(lo - 1)), Gt(Set(hi + 1), block));
+}
+
+Block MatchSpace(Block block) {
+  return Or(Eq(block, Set(' ')), InRange(block, '\t', '\r'));
+}
+
+Block MatchIdentifier(Block block) {
+  // 转为小写后判断是否是字母
+  auto letter{InRange(Or(block, Set(0x20)), 'a', 'z')};
+  auto digit{InRange(block, '0', '9')};
+  auto other{Or(Eq(block, Set('_')), Eq(block, Set('$')))};
+  // 0x80 ~ 0xfd 作为有符号数为 -128 ~ -3
+  auto non_ascii{Gt(Set(-2), block)};
+  return Or(Or(letter, digit), Or(other, non_ascii));
+}
+
+Block MatchDigit(Block block) { return InRange(block, '0', '9'); }
+
+// 返回不满足条件的位置
+template <typename Match>
+std::size_t SpanBlocks(std::string_view str, std::size_t &index,
+                       Match match) {
+  for (; index + BlockSize <= std::size(str); index += BlockSize) {
+    if (auto stop{Mask(match(Load(str.data() + index))) ^ FullMask};
+        stop != 0) {
+      return index + std::countr_zero(stop);
+    }
+  }
+
+  return std::string_view::npos;
+}
+
+#endif
+
+template <typename Match>
+std::size_t SpanScalar(std::string_view str, std::size_t index, Match match) {
+  while (index < std::size(str) && match(str[index])) {
+    ++index;
+  }
+  return index;
+}
+
+}  // namespace
+
+std::size_t SpanSpace(std::string_view str) {
+  std::size_t index{};
+
+#ifdef KCC_SIMD
+  if (auto end{SpanBlocks(str, index, MatchSpace)};
+      end != std::string_view::npos) {
+    return end;
+  }
+#endif
+
+  return SpanScalar(str, index, IsSpace);
+}
+
+std::size_t SpanIdentifier(std::string_view str) {
+  std::size_t index{};
+
+#ifdef KCC_SIMD
+  if (auto end{SpanBlocks(str, index, MatchIdentifier)};
+      end != std::string_view::npos) {
+    return end;
+  }
+#endif
+
+  return SpanScalar(str, index, IsIdentifier);
+}
+
+std::size_t SpanDigit(std::string_view str) {
+  std::size_t index{};
+
+#ifdef KCC_SIMD
+  if (auto end{SpanBlocks(str, index, MatchDigit)};
+      end != std::string_view::npos) {
+    return end;
+  }
+#endif
+
+  return SpanScalar(str, index, IsDigit);
+}
+
+std::size_t SpanQuoted(std::string_view str, char quote) {
+  std::size_t index{};
+
+#ifdef KCC_SIMD
+  if (auto end{SpanBlocks(str, index,
+                          [quote](Block block) {
+                            auto stop{Or(Or(Eq(block, Set(quote)),
+                                            Eq(block, Set('\\'))),
+                                         Or(Eq(block, Set('\n')),
+                                            Eq(block, Set('\0'))))};
+                            return Eq(stop, Set(0));
+                          })};
+      end != std::string_view::npos) {
+    return end;
+  }
+#endif
+
+  return SpanScalar(str, index, [quote](char ch) {
+    return ch != quote && ch != '\\' && ch != '\n' && ch != '\0';
+  });
+}
+
+}  // namespace kcc
@@ -81,12 +81,10 @@ bool Link() {
   std::string str{"-o" + OutputFilePath};
   args.push_back(str.c_str());
 
+  // 没有使用 -flto 时, 输入中的 bitcode 目标文件由 lld 自己做 LTO
   auto level{static_cast<std::int32_t>(OptimizationLevel.getValue())};
-  std::string level_str{"-plugin-opt=O" + std::to_string(level)};
-  if (level != 0) {
-    args.push_back("-plugin=/usr/bin/../lib/LLVMgold.so");
-    args.push_back(level_str.c_str());
-  }
+  std::string level_str{"--lto-O" + std::to_string(level)};
+  args.push_back(level_str.c_str());
 
   // TODO 后两个参数的作用
   return lld::elf::link(args, false, llvm::outs(), llvm::errs());
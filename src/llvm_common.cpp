@@ -6,10 +6,6 @@
 
 #include <cassert>
 
-#include <clang/Basic/LangOptions.h>
-#include <clang/Basic/LangStandard.h>
-#include <clang/Basic/TargetOptions.h>
-#include <clang/Frontend/FrontendOptions.h>
 #include <llvm/ADT/Optional.h>
 #include <llvm/Support/Casting.h>
 #include <llvm/Support/CodeGen.h>
@@ -24,42 +20,14 @@
 namespace kcc {
 
 void InitLLVM() {
-  llvm::InitializeAllTargets();
-  llvm::InitializeAllTargetInfos();
-  llvm::InitializeAllTargetMCs();
-  llvm::InitializeAllAsmPrinters();
-  llvm::InitializeAllAsmParsers();
-
-  Ci.createDiagnostics();
+  // 只生成默认目标平台的代码, 不需要初始化所有目标平台
+  llvm::InitializeNativeTarget();
+  llvm::InitializeNativeTargetAsmPrinter();
+  llvm::InitializeNativeTargetAsmParser();
+}
 
-  auto pto{std::make_shared<clang::TargetOptions>()};
+std::unique_ptr<llvm::TargetMachine> CreateTargetMachine() {
   auto target_triple{llvm::sys::getDefaultTargetTriple()};
-  pto->Triple = target_triple;
-
-  TargetInfo = clang::TargetInfo::CreateTargetInfo(Ci.getDiagnostics(), pto);
-
-  Ci.setTarget(TargetInfo);
-  Ci.getInvocation().setLangDefaults(
-      Ci.getLangOpts(), clang::InputKind{clang::Language::C},
-      TargetInfo->getTriple(), Ci.getPreprocessorOpts(),
-      clang::LangStandard::lang_c17);
-
-  auto &lang_opt{Ci.getLangOpts()};
-  lang_opt.C17 = true;
-  lang_opt.Digraphs = true;
-  lang_opt.Trigraphs = true;
-  lang_opt.GNUMode = true;
-  lang_opt.GNUKeywords = true;
-
-  Ci.createFileManager();
-  Ci.createSourceManager(Ci.getFileManager());
-
-  Ci.createPreprocessor(clang::TranslationUnitKind::TU_Complete);
-
-  Module = std::make_unique<llvm::Module>("", Context);
-  Module->addModuleFlag(llvm::Module::Error, "wchar_size", 4);
-  Module->addModuleFlag(llvm::Module::Max, "PIC Level", llvm::PICLevel::BigPIC);
-  Module->addModuleFlag(llvm::Module::Max, "PIE Level", llvm::PIELevel::Large);
 
   std::string error;
   auto target{llvm::TargetRegistry::lookupTarget(target_triple, error)};
@@ -73,12 +41,8 @@ void InitLLVM() {
   std::string features;
   llvm::TargetOptions opt;
   llvm::Optional<llvm::Reloc::Model> rm{llvm::Reloc::Model::PIC_};
-  TargetMachine = std::unique_ptr<llvm::TargetMachine>{
+  return std::unique_ptr<llvm::TargetMachine>{
       target->createTargetMachine(target_triple, cpu, features, opt, rm)};
-
-  // 配置模块以指定目标机器和数据布局
-  Module->setTargetTriple(target_triple);
-  Module->setDataLayout(TargetMachine->createDataLayout());
 }
 
 std::string LLVMTypeToStr(llvm::Type *type) {
@@ -212,7 +176,7 @@ llvm::Constant *ConstantCastTo(llvm::Constant *value, llvm::Type *to,
   } else if (to->isVoidTy() || value->getType() == to) {
     return value;
   } else if (IsArrCastToPtr(value, to)) {
-    auto zero{llvm::ConstantInt::get(Builder.getInt64Ty(), 0)};
+    auto zero{llvm::ConstantInt::get(Builder().getInt64Ty(), 0)};
     llvm::Constant *index[]{zero, zero};
     return llvm::ConstantExpr::getInBoundsGetElementPtr(nullptr, value, index);
   } else if (IsPointerTy(value) && to->isPointerTy()) {
@@ -251,39 +215,39 @@ llvm::Value *CastTo(llvm::Value *value, llvm::Type *to, bool is_unsigned) {
 
   if (IsIntegerTy(value) && to->isIntegerTy()) {
     if (is_unsigned) {
-      return Builder.CreateZExtOrTrunc(value, to);
+      return Builder().CreateZExtOrTrunc(value, to);
     } else {
-      return Builder.CreateSExtOrTrunc(value, to);
+      return Builder().CreateSExtOrTrunc(value, to);
     }
   } else if (IsIntegerTy(value) && to->isFloatingPointTy()) {
     if (is_unsigned) {
-      return Builder.CreateUIToFP(value, to);
+      return Builder().CreateUIToFP(value, to);
     } else {
-      return Builder.CreateSIToFP(value, to);
+      return Builder().CreateSIToFP(value, to);
     }
   } else if (IsFloatingPointTy(value) && to->isIntegerTy()) {
     if (is_unsigned) {
-      return Builder.CreateFPToUI(value, to);
+      return Builder().CreateFPToUI(value, to);
     } else {
-      return Builder.CreateFPToSI(value, to);
+      return Builder().CreateFPToSI(value, to);
     }
   } else if (IsFloatingPointTy(value) && to->isFloatingPointTy()) {
     if (FloatPointRank(value->getType()) > FloatPointRank(to)) {
-      return Builder.CreateFPTrunc(value, to);
+      return Builder().CreateFPTrunc(value, to);
     } else {
-      return Builder.CreateFPExt(value, to);
+      return Builder().CreateFPExt(value, to);
     }
   } else if (IsPointerTy(value) && to->isIntegerTy()) {
-    return Builder.CreatePtrToInt(value, to);
+    return Builder().CreatePtrToInt(value, to);
   } else if (IsIntegerTy(value) && to->isPointerTy()) {
-    return Builder.CreateIntToPtr(value, to);
+    return Builder().CreateIntToPtr(value, to);
   } else if (to->isVoidTy() || value->getType() == to) {
     return value;
   } else if (IsArrCastToPtr(value, to)) {
-    return Builder.CreateInBoundsGEP(
-        value, {Builder.getInt64(0), Builder.getInt64(0)});
+    return Builder().CreateInBoundsGEP(
+        value, {Builder().getInt64(0), Builder().getInt64(0)});
   } else if (IsPointerTy(value) && to->isPointerTy()) {
-    return Builder.CreatePointerCast(value, to);
+    return Builder().CreatePointerCast(value, to);
   } else {
     Error("can not cast this expression with type '{}' to '{}'",
           LLVMTypeToStr(value->getType()), LLVMTypeToStr(to));
@@ -298,9 +262,9 @@ llvm::Value *CastToBool(llvm::Value *value) {
   }
 
   if (IsIntegerTy(value) || IsPointerTy(value)) {
-    return Builder.CreateICmpNE(value, GetZero(value->getType()));
+    return Builder().CreateICmpNE(value, GetZero(value->getType()));
   } else if (IsFloatingPointTy(value)) {
-    return Builder.CreateFCmpONE(value, GetZero(value->getType()));
+    return Builder().CreateFCmpONE(value, GetZero(value->getType()));
   } else {
     Error("this constant expression can not cast to bool: '{}'",
           LLVMTypeToStr(value->getType()));
@@ -325,7 +289,7 @@ llvm::Value *GetZero(llvm::Type *type) {
 llvm::GlobalVariable *CreateGlobalString(llvm::Constant *init,
                                          std::int32_t align) {
   assert(init != nullptr);
-  auto var{new llvm::GlobalVariable(*Module, init->getType(), true,
+  auto var{new llvm::GlobalVariable(Module(), init->getType(), true,
                                     llvm::GlobalValue::PrivateLinkage, init,
                                     ".str")};
   var->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Global);
@@ -354,13 +318,14 @@ llvm::GlobalVariable *CreateGlobalVar(const ObjectExpr *obj) {
 
   auto name{obj->GetName()};
 
-  if (auto iter{GlobalVarMap.find(name)}; iter != std::end(GlobalVarMap)) {
+  auto &global_var_map{GetContext().global_var_map};
+  if (auto iter{global_var_map.find(name)}; iter != std::end(global_var_map)) {
     ptr = iter->second;
   } else {
-    ptr = new llvm::GlobalVariable(*Module, obj->GetType()->GetLLVMType(),
+    ptr = new llvm::GlobalVariable(Module(), obj->GetType()->GetLLVMType(),
                                    obj->GetQualType().IsConst(), linkage,
                                    nullptr, name);
-    GlobalVarMap[name] = ptr;
+    global_var_map[name] = ptr;
   }
 
   if (!obj->IsStatic() && !obj->IsExtern()) {
@@ -385,27 +350,27 @@ const llvm::fltSemantics &GetFloatTypeSemantics(llvm::Type *type) {
   assert(type->isFloatingPointTy());
 
   if (type->isFloatTy()) {
-    return TargetInfo->getFloatFormat();
+    return TargetInfo().getFloatFormat();
   } else if (type->isDoubleTy()) {
-    return TargetInfo->getDoubleFormat();
+    return TargetInfo().getDoubleFormat();
   } else if (type->isX86_FP80Ty()) {
-    return TargetInfo->getLongDoubleFormat();
+    return TargetInfo().getLongDoubleFormat();
   } else {
     assert(false);
-    return TargetInfo->getDoubleFormat();
+    return TargetInfo().getDoubleFormat();
   }
 }
 
 llvm::Type *GetBitFieldSpace(std::int8_t width) {
   if (width <= 8) {
-    return Builder.getInt8Ty();
+    return Builder().getInt8Ty();
   } else {
-    return llvm::ArrayType::get(Builder.getInt8Ty(), (width + 7) / 8);
+    return llvm::ArrayType::get(Builder().getInt8Ty(), (width + 7) / 8);
   }
 }
 
 std::int32_t GetLLVMTypeSize(llvm::Type *type) {
-  return Module->getDataLayout().getTypeAllocSize(type);
+  return Module().getDataLayout().getTypeAllocSize(type);
 }
 
 llvm::Constant *GetBitField(llvm::Constant *value, std::int32_t size,
@@ -431,7 +396,7 @@ llvm::Constant *GetBitField(llvm::Constant *value, std::int32_t size,
 
     return llvm::ConstantExpr::getAnd(
         value,
-        llvm::ConstantInt::get(Builder.getInt32Ty(), low_one | high_one));
+        llvm::ConstantInt::get(Builder().getInt32Ty(), low_one | high_one));
   } else if (size == 32) {
     std::uint32_t low_one;
     if (begin) {
@@ -449,7 +414,7 @@ llvm::Constant *GetBitField(llvm::Constant *value, std::int32_t size,
 
     return llvm::ConstantExpr::getAnd(
         value,
-        llvm::ConstantInt::get(Builder.getInt32Ty(), low_one | high_one));
+        llvm::ConstantInt::get(Builder().getInt32Ty(), low_one | high_one));
   } else {
     assert(false);
     return nullptr;
@@ -477,7 +442,7 @@ llvm::Value *GetBitField(llvm::Value *value, std::int32_t size,
       high_one = ~zero << bit;
     }
 
-    return Builder.CreateAnd(value, low_one | high_one);
+    return Builder().CreateAnd(value, low_one | high_one);
   } else if (size == 32) {
     std::uint32_t low_one;
     if (begin) {
@@ -493,7 +458,7 @@ llvm::Value *GetBitField(llvm::Value *value, std::int32_t size,
       high_one = ~0U << bit;
     }
 
-    return Builder.CreateAnd(value, low_one | high_one);
+    return Builder().CreateAnd(value, low_one | high_one);
   } else {
     assert(false);
     return nullptr;
@@ -503,12 +468,12 @@ llvm::Value *GetBitField(llvm::Value *value, std::int32_t size,
 llvm::Value *GetBitFieldValue(llvm::Value *value, std::int32_t size,
                               std::int32_t width, std::int32_t begin,
                               bool is_unsigned) {
-  value = Builder.CreateShl(value, size - (begin + width));
+  value = Builder().CreateShl(value, size - (begin + width));
 
   if (is_unsigned) {
-    return Builder.CreateLShr(value, size - width);
+    return Builder().CreateLShr(value, size - width);
   } else {
-    return Builder.CreateAShr(value, size - width);
+    return Builder().CreateAShr(value, size - width);
   }
 }
 
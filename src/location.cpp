@@ -4,86 +4,181 @@
 
 #include "location.h"
 
+#include <algorithm>
 #include <cassert>
-#include <cstring>
+#include <iterator>
+#include <limits>
 
 #include <fmt/format.h>
 
+#include "context.h"
+#include "error.h"
+
 namespace kcc {
 
-void Location::SetFileName(const std::string &file_name) {
-  assert(!std::empty(file_name));
-  file_name_ = file_name;
-}
+namespace {
 
-void Location::SetContent(const char *content) {
-  assert(content != nullptr);
-  content_ = content;
-}
+struct Resolved {
+  SourceFile *file;
+  std::uint32_t offset;
+};
 
-void Location::NextColumn() { ++column_; }
+Resolved Resolve(Location loc) {
+  assert(loc.IsValid());
 
-void Location::NextRow(std::size_t line_begin) {
-  line_begin_backup_ = line_begin;
-  column_backup_ = column_;
+  auto &files{GetContext().files};
+  auto iter{std::upper_bound(
+      std::begin(files), std::end(files), loc.GetOffset(),
+      [](std::uint32_t value, const SourceFile &file) {
+        return value < file.begin;
+      })};
+  assert(iter != std::begin(files));
+  --iter;
 
-  line_begin_ = line_begin;
-  ++row_;
-  column_ = 1;
+  return {&*iter, loc.GetOffset() - iter->begin};
 }
 
-void Location::PrevRow() {
-  assert(row_ > 1);
+const LineMarker &FindMarker(const SourceFile &file, std::uint32_t offset) {
+  auto iter{std::upper_bound(
+      std::begin(file.markers), std::end(file.markers), offset,
+      [](std::uint32_t value, const LineMarker &marker) {
+        return value < marker.offset;
+      })};
+  assert(iter != std::begin(file.markers));
+  return *(iter - 1);
+}
 
-  line_begin_ = line_begin_backup_;
-  column_ = column_backup_;
+const std::vector<std::uint32_t> &GetLineBegins(SourceFile &file) {
+  if (std::empty(file.line_begins)) {
+    auto content{file.content};
 
-  --row_;
+    file.line_begins.push_back(0);
+    for (auto index{content.find('\n')}; index != std::string_view::npos;
+         index = content.find('\n', index + 1)) {
+      file.line_begins.push_back(index + 1);
+    }
+  }
+
+  return file.line_begins;
 }
 
-void Location::PrevColumn() {
-  assert(column_ > 1);
-  --column_;
+// offset 所在行的下标
+std::size_t GetLineIndex(SourceFile &file, std::uint32_t offset) {
+  const auto &line_begins{GetLineBegins(file)};
+  auto iter{std::upper_bound(std::begin(line_begins), std::end(line_begins),
+                             offset)};
+  return iter - std::begin(line_begins) - 1;
 }
 
-// row 代表的是下一行的行号
-void Location::SetRow(std::int32_t row) {
-  assert(row >= 0);
-  row_ = row;
+}  // namespace
+
+Location::Location(std::uint32_t offset) : offset_{offset} {}
+
+bool Location::IsValid() const { return offset_ != 0; }
+
+std::uint32_t Location::GetOffset() const { return offset_; }
+
+Location Location::GetLocWithOffset(std::size_t offset) const {
+  return IsValid() ? Location{static_cast<std::uint32_t>(offset_ + offset)}
+                   : Location{};
 }
 
 std::string Location::GetFileName() const {
-  assert(!std::empty(file_name_));
-  return file_name_;
+  auto [file, offset]{Resolve(*this)};
+  return FindMarker(*file, offset).file_name.GetName();
 }
 
 std::string Location::ToLocStr() const {
-  assert(!std::empty(file_name_));
-  return fmt::format(FMT_STRING("{}:{}:{}"), file_name_, row_, column_);
+  return fmt::format(FMT_STRING("{}:{}:{}"), GetFileName(), GetRow(),
+                     GetColumn());
 }
 
 std::string Location::GetLineContent() const {
-  assert(content_ != nullptr);
-
-  std::string str;
-  auto size{std::strlen(content_)};
+  auto [file, offset]{Resolve(*this)};
+  const auto &line_begins{GetLineBegins(*file)};
+  auto index{GetLineIndex(*file, offset)};
 
-  for (auto index{line_begin_}; index < size && content_[index] != '\n';
-       ++index) {
-    str.push_back(content_[index]);
-  }
+  auto begin{line_begins[index]};
+  // 不包括换行符
+  auto end{index + 1 < std::size(line_begins) ? line_begins[index + 1] - 1
+                                              : std::size(file->content)};
 
+  std::string str{file->content.substr(begin, end - begin)};
   str += '\n';
 
   return str;
 }
 
 std::string Location::GetPositionArrow() const {
-  return fmt::format(FMT_STRING("{}{}\n"), std::string(column_ - 1, ' '), "^");
+  return fmt::format(FMT_STRING("{}{}\n"), std::string(GetColumn() - 1, ' '),
+                     "^");
 }
 
-std::int32_t Location::GetRow() const { return row_; }
+// 无效的位置 (如类型的默认位置) 行号和列号为 1
+std::int32_t Location::GetRow() const {
+  if (!IsValid()) {
+    return 1;
+  }
+
+  auto [file, offset]{Resolve(*this)};
+  const auto &marker{FindMarker(*file, offset)};
+
+  auto lines{GetLineIndex(*file, offset) - GetLineIndex(*file, marker.offset)};
+  return marker.row + static_cast<std::int32_t>(lines);
+}
 
-std::int32_t Location::GetColumn() const { return column_; }
+std::int32_t Location::GetColumn() const {
+  if (!IsValid()) {
+    return 1;
+  }
+
+  auto [file, offset]{Resolve(*this)};
+  return offset - GetLineBegins(*file)[GetLineIndex(*file, offset)] + 1;
+}
+
+Location AddSourceFile(std::string_view file_name, std::string_view content) {
+  auto &context{GetContext()};
+
+  // 文件结尾也占据一个位置
+  if (std::numeric_limits<std::uint32_t>::max() - context.next_begin <
+      std::size(content) + 1) {
+    Error("translation unit is too large: '{}'", file_name);
+  }
+
+  Location loc{context.next_begin};
+
+  auto &file{context.files.emplace_back()};
+  file.begin = context.next_begin;
+  file.content = content;
+  file.markers.push_back({0, Symbol{file_name}, 1});
+
+  context.next_begin += std::size(content) + 1;
+
+  return loc;
+}
+
+void AddLineMarker(Location loc, std::string_view file_name,
+                   std::int32_t row) {
+  auto [file, offset]{Resolve(loc)};
+
+  // 一般按顺序添加
+  auto iter{std::upper_bound(
+      std::begin(file->markers), std::end(file->markers), offset,
+      [](std::uint32_t value, const LineMarker &marker) {
+        return value < marker.offset;
+      })};
+  file->markers.insert(iter, {offset, Symbol{file_name}, row});
+}
+
+std::pair<std::size_t, std::uint32_t> DecomposeLocation(Location loc) {
+  auto [file, offset]{Resolve(loc)};
+  return {file - GetContext().files.data(), offset};
+}
+
+const SourceFile &GetSourceFile(std::size_t index) {
+  const auto &files{GetContext().files};
+  assert(index < std::size(files));
+  return files[index];
+}
 
 }  // namespace kcc
@@ -0,0 +1,247 @@
+//
+// Created by kaiser on 2026/10/16.
+//
+
+#include "lto.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <llvm/BinaryFormat/Magic.h>
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/IR/GlobalValue.h>
+#include <llvm/LTO/Caching.h>
+#include <llvm/LTO/Config.h>
+#include <llvm/LTO/LTO.h>
+#include <llvm/Linker/Linker.h>
+#include <llvm/Support/CachePruning.h>
+#include <llvm/Support/CodeGen.h>
+#include <llvm/Support/Error.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Threading.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Transforms/IPO/Internalize.h>
+
+#include "cache.h"
+#include "context.h"
+#include "error.h"
+#include "llvm_common.h"
+#include "obj_gen.h"
+#include "opt.h"
+#include "util.h"
+
+namespace kcc {
+
+namespace {
+
+// 本地目标文件和静态库可能引用任意的外部符号, 只有在没有它们时,
+// 才能认为可执行文件中只有 main 会被外部引用
+bool CanInternalize(const std::vector<std::string> &native_files) {
+  return !Shared && std::empty(native_files) && std::empty(AFile);
+}
+
+void FullLto(const std::vector<std::unique_ptr<llvm::MemoryBuffer>> &inputs,
+             std::vector<std::string> &native_files) {
+  // 在驱动程序的线程中合并所有的模块, 出错时由 RunDriver 清理
+  CompilationContext context;
+  ContextScope scope{context};
+
+  llvm::Linker linker{Module()};
+  for (const auto &item : inputs) {
+    auto module{llvm::parseBitcodeFile(item->getMemBufferRef(), Context())};
+    if (!module) {
+      Error("{}", llvm::toString(module.takeError()));
+    }
+
+    if (linker.linkInModule(std::move(*module))) {
+      Error("can not link '{}'", item->getBufferIdentifier().str());
+    }
+  }
+
+  if (CanInternalize(native_files)) {
+    llvm::internalizeModule(Module(), [](const llvm::GlobalValue &value) {
+      return value.getName() == "main";
+    });
+  }
+
+  Optimization();
+
+  auto obj_file{CreateObjFile("lto")};
+  ObjGen(obj_file);
+  native_files.push_back(obj_file);
+}
+
+// 由 llvm::lto::LTO 完成 thin link (函数导入和导出分析),
+// 之后各个模块的优化和代码生成在线程池中并行进行
+void ThinLto(const std::vector<std::unique_ptr<llvm::MemoryBuffer>> &inputs,
+             std::vector<std::string> &native_files) {
+  auto level{static_cast<std::uint32_t>(OptimizationLevel.getValue())};
+
+  llvm::lto::Config config;
+  config.CPU = "generic";
+  config.RelocModel = llvm::Reloc::Model::PIC_;
+  config.OptLevel = level;
+  config.CGOptLevel =
+      level == 0 ? llvm::CodeGenOpt::None : llvm::CodeGenOpt::Default;
+
+  llvm::lto::LTO lto{std::move(config),
+                     llvm::lto::createInProcessThinBackend(
+                         llvm::heavyweight_hardware_concurrency(Jobs))};
+
+  std::vector<std::unique_ptr<llvm::lto::InputFile>> files;
+  for (const auto &item : inputs) {
+    auto input{llvm::lto::InputFile::create(item->getMemBufferRef())};
+    if (!input) {
+      Error("{}", llvm::toString(input.takeError()));
+    }
+    files.push_back(std::move(*input));
+  }
+
+  // 强定义优先于 common 定义, common 定义优先于弱定义,
+  // 同一等级中第一个定义胜出
+  auto rank{[](const llvm::lto::InputFile::Symbol &symbol) {
+    if (symbol.isCommon()) {
+      return 1;
+    } else if (symbol.isWeak()) {
+      return 0;
+    } else {
+      return 2;
+    }
+  }};
+
+  // 符号名 -> (等级, 所在文件的下标, 在文件中的下标)
+  std::unordered_map<std::string,
+                     std::tuple<std::int32_t, std::size_t, std::size_t>>
+      prevailing;
+  for (std::size_t i{}; i < std::size(files); ++i) {
+    auto symbols{files[i]->symbols()};
+    for (std::size_t j{}; j < std::size(symbols); ++j) {
+      if (symbols[j].isUndefined()) {
+        continue;
+      }
+
+      auto [iter, inserted]{prevailing.try_emplace(
+          symbols[j].getName().str(), rank(symbols[j]), i, j)};
+      if (!inserted && std::get<0>(iter->second) < rank(symbols[j])) {
+        iter->second = {rank(symbols[j]), i, j};
+      }
+    }
+  }
+
+  auto internalize{CanInternalize(native_files)};
+
+  for (std::size_t i{}; i < std::size(files); ++i) {
+    std::vector<llvm::lto::SymbolResolution> resolutions;
+    auto symbols{files[i]->symbols()};
+    for (std::size_t j{}; j < std::size(symbols); ++j) {
+      llvm::lto::SymbolResolution resolution;
+      if (!symbols[j].isUndefined()) {
+        const auto &item{prevailing.at(symbols[j].getName().str())};
+        resolution.Prevailing =
+            std::get<1>(item) == i && std::get<2>(item) == j;
+      }
+      // 只有胜出的定义是链接单元中的最终定义
+      resolution.FinalDefinitionInLinkageUnit =
+          !Shared && resolution.Prevailing;
+      resolution.VisibleToRegularObj =
+          !internalize || symbols[j].getName() == "main";
+      resolutions.push_back(resolution);
+    }
+
+    if (auto error{lto.add(std::move(files[i]), resolutions)}) {
+      Error("{}", llvm::toString(std::move(error)));
+    }
+  }
+
+  // 每个任务的输出各自写入一个内存文件, 没有输出的任务不参与链接
+  std::vector<std::string> outputs;
+  for (std::size_t i{}; i < lto.getMaxTasks(); ++i) {
+    outputs.push_back(CreateObjFile("thinlto" + std::to_string(i)));
+  }
+  std::vector<char> written(std::size(outputs));
+
+  auto add_stream{[&](std::size_t task) {
+    std::error_code error_code;
+    auto os{std::make_unique<llvm::raw_fd_ostream>(outputs[task], error_code)};
+    if (error_code) {
+      Error("Could not open file: '{}'", error_code.message());
+    }
+
+    written[task] = true;
+    return std::make_unique<llvm::lto::NativeObjectStream>(std::move(os));
+  }};
+
+  // 与 -fcache 共用缓存目录, 重新链接时未改变的模块直接使用缓存的结果
+  llvm::lto::NativeObjectCache cache;
+  std::string cache_dir;
+  if (FCache) {
+    cache_dir = (GetCacheDir() / "thinlto").string();
+
+    auto local_cache{llvm::lto::localCache(
+        cache_dir,
+        [&](std::size_t task, std::unique_ptr<llvm::MemoryBuffer> mb) {
+          *add_stream(task)->OS << mb->getBuffer();
+        })};
+    if (!local_cache) {
+      Error("{}", llvm::toString(local_cache.takeError()));
+    }
+    cache = std::move(*local_cache);
+  }
+
+  if (auto error{lto.run(add_stream, cache)}) {
+    Error("{}", llvm::toString(std::move(error)));
+  }
+
+  if (!std::empty(cache_dir)) {
+    llvm::CachePruningPolicy policy;
+    policy.MaxSizeBytes = static_cast<std::uint64_t>(CacheSize) * 1024 * 1024;
+    llvm::pruneCache(cache_dir, policy);
+  }
+
+  for (std::size_t i{}; i < std::size(outputs); ++i) {
+    if (written[i]) {
+      native_files.push_back(outputs[i]);
+    }
+  }
+}
+
+}  // namespace
+
+void LinkTimeOptimization() {
+  std::vector<std::unique_ptr<llvm::MemoryBuffer>> bitcode_files;
+  std::vector<std::string> native_files;
+
+  for (const auto &item : ObjFile) {
+    auto buffer{llvm::MemoryBuffer::getFile(item)};
+    if (!buffer) {
+      Error("can not read '{}': {}", item, buffer.getError().message());
+    }
+
+    if (llvm::identify_magic((*buffer)->getBuffer()) ==
+        llvm::file_magic::bitcode) {
+      bitcode_files.push_back(std::move(*buffer));
+    } else {
+      native_files.push_back(item);
+    }
+  }
+
+  if (std::empty(bitcode_files)) {
+    return;
+  }
+
+  if (FLto == LtoKinds::kThin) {
+    ThinLto(bitcode_files, native_files);
+  } else {
+    FullLto(bitcode_files, native_files);
+  }
+
+  ObjFile = std::move(native_files);
+}
+
+}  // namespace kcc
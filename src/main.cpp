@@ -2,77 +2,157 @@
 // Created by kaiser on 2019/10/30.
 //
 
-#include <unistd.h>
-#include <wait.h>
-
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <cstdlib>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <system_error>
+#include <thread>
 #include <utility>
+#include <vector>
 
+#include <fmt/format.h>
+#include <llvm/ADT/ScopeExit.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Path.h>
 #include <llvm/Support/raw_ostream.h>
 #include <llvm/Target/TargetMachine.h>
 
+#include "cache.h"
 #include "code_gen.h"
+#include "context.h"
 #include "cpp.h"
 #include "error.h"
+#include "header_cache.h"
+#include "job_server.h"
 #include "json_gen.h"
 #include "lex.h"
 #include "link.h"
 #include "llvm_common.h"
+#include "location.h"
+#include "lto.h"
 #include "obj_gen.h"
 #include "opt.h"
 #include "parse.h"
+#include "server.h"
+#include "token_stream.h"
 #include "util.h"
 
 using namespace kcc;
 
+std::int32_t RunDriver();
+
 void RunKcc(const std::string &file_name);
 
+std::string GetObjOutput(const std::string &file_name);
+
+bool RunKccInContext(const std::string &file_name);
+
+void PrintLexThroughput(const std::string &file_name, std::size_t size,
+                        TimePoint start);
+
 #ifdef DEV
-#include <cstdlib>
 void RunDev();
 #endif
 
 int main(int argc, char *argv[]) try {
-  InitLLVM();
+  // 在初始化 LLVM 之前, 尽早把请求转发给编译服务器
+  if (auto status{RunClient(argc, argv)}) {
+    return *status;
+  }
 
+  // -help 和 -v 不需要初始化 LLVM
   InitCommandLine(argc, argv);
+
+  if (Server) {
+    InitLLVM();
+    RunServer(RunDriver);
+  }
+
+  return RunDriver();
+} catch (const CompilationError &) {
+  return EXIT_FAILURE;
+} catch (const std::exception &error) {
+  Error("{}", error.what());
+}
+
+std::int32_t RunDriver() {
   CommandLineCheck();
+  InitLLVM();
 
 #ifdef DEV
   if (DevMode) {
+    CompilationContext context;
+    ContextScope scope{context};
     RunDev();
     return EXIT_SUCCESS;
   }
 #endif
 
   TimingStart();
+
+  // 先编译较大的文件, 避免其落在关键路径的末尾
+  std::vector<std::pair<std::string, std::uintmax_t>> files;
   for (const auto &item : InputFilePaths) {
-    auto pid{fork()};
-    if (pid < 0) {
-      Error("fork error");
-    } else if (pid == 0) {
-      RunKcc(item);
-      PrintWarnings();
-      return EXIT_SUCCESS;
-    }
+    files.emplace_back(item,
+                       item == "-" ? 0 : std::filesystem::file_size(item));
   }
+  std::stable_sort(std::begin(files), std::end(files),
+                   [](const auto &lhs, const auto &rhs) {
+                     return lhs.second > rhs.second;
+                   });
+
+  JobServer job_server;
+  std::atomic<std::size_t> next_file{};
+  // 一个翻译单元失败时其他翻译单元继续编译, 以便报告所有的错误
+  std::atomic<bool> failed{};
+  std::mutex timing_mutex;
+
+  auto worker{[&] {
+    for (auto index{next_file++}; index < std::size(files);
+         index = next_file++) {
+      const auto &file_name{files[index].first};
+
+      job_server.Acquire();
+      auto start{Now()};
+      if (!RunKccInContext(file_name)) {
+        failed = true;
+      }
+      job_server.Release();
 
-  std::int32_t status{};
-
-  while (waitpid(-1, &status, 0) > 0) {
-    // WIFEXITED 如果通过调用 exit 或者 return 正常终止, 则为真
-    // WEXITSTATUS 返回一个正常终止的子进程的退出状态, 只有在
-    // WIFEXITED 为真时才会定义
-    if (!WIFEXITED(status) || WEXITSTATUS(status)) {
-      Error("Compile Error");
+      std::lock_guard lock{timing_mutex};
+      TimingEnd(file_name, start);
     }
+  }};
+
+  std::vector<std::thread> workers;
+  for (std::uint32_t i{}; i < Jobs && i < std::size(files); ++i) {
+    workers.emplace_back(worker);
+  }
+  for (auto &item : workers) {
+    item.join();
+  }
+  PrintWarnings();
+
+  if (failed) {
+    RemoveFiles();
+    return EXIT_FAILURE;
   }
 
+  CacheTrim();
+  PrintCacheStatistics();
+  PrintHeaderCacheStatistics();
+
   if (DoNotLink()) {
     TimingEnd("Timing");
     return EXIT_SUCCESS;
@@ -82,6 +162,17 @@ int main(int argc, char *argv[]) try {
     OutputFilePath = "a.out";
   }
 
+  if (FLto != LtoKinds::kNone) {
+    auto start{Now()};
+    try {
+      LinkTimeOptimization();
+    } catch (const CompilationError &) {
+      RemoveFiles();
+      return EXIT_FAILURE;
+    }
+    TimingEnd("LTO", start);
+  }
+
   if (!Link()) {
     RemoveFiles();
     Error("Link Failed");
@@ -90,19 +181,63 @@ int main(int argc, char *argv[]) try {
   }
 
   TimingEnd("Timing");
-} catch (const std::exception &error) {
-  Error("{}", error.what());
+
+  return EXIT_SUCCESS;
+}
+
+// 每个翻译单元有自己的编译上下文, 在调用者 (-j 的工作线程) 中编译,
+// 出错时只终止该翻译单元, 返回是否成功
+bool RunKccInContext(const std::string &file_name) {
+  CompilationContext context;
+  ContextScope scope{context};
+
+  try {
+    try {
+      RunKcc(file_name);
+    } catch (const std::exception &error) {
+      Error("{}", error.what());
+    }
+  } catch (const CompilationError &) {
+    return false;
+  }
+
+  return true;
+}
+
+void PrintLexThroughput(const std::string &file_name, std::size_t size,
+                        TimePoint start) {
+  if (Timing) {
+    auto seconds{std::chrono::duration<double>(Now() - start).count()};
+    std::cout << fmt::format(FMT_STRING("{} (lex): {:.2f} GB/s\n"), file_name,
+                             size / seconds / 1e9)
+              << std::flush;
+  }
 }
 
 void RunKcc(const std::string &file_name) {
   Preprocessor preprocessor;
+  // 已经预处理过的文件映射到内存中进行词法分析, 记号直接引用映射的内容
+  std::unique_ptr<llvm::MemoryBuffer> preprocessed_file;
+  // 警告在输出时才读取源代码, 需要在预处理器和映射的文件释放之前输出
+  auto print_warnings{llvm::make_scope_exit(PrintWarnings)};
+
   preprocessor.AddIncludePaths(IncludePaths);
   preprocessor.AddMacroDefinitions(MacroDefines);
 
-  auto preprocessed_code{preprocessor.Cpp(file_name)};
+  if (EmitPch) {
+    preprocessor.EmitPch(file_name, std::empty(OutputFilePath)
+                                        ? file_name + ".pch"
+                                        : OutputFilePath.getValue());
+    return;
+  }
+
+  if (!std::empty(IncludePch)) {
+    preprocessor.IncludePch(IncludePch);
+  }
 
   if (Preprocess) {
-    if (std::empty(OutputFilePath)) {
+    auto preprocessed_code{preprocessor.Cpp(file_name)};
+    if (std::empty(OutputFilePath) || OutputFilePath == "-") {
       std::cout << preprocessed_code << '\n' << std::endl;
     } else {
       std::ofstream ofs{OutputFilePath};
@@ -111,11 +246,46 @@ void RunKcc(const std::string &file_name) {
     return;
   }
 
-  Scanner scanner{std::move(preprocessed_code)};
-  auto tokens{scanner.Tokenize()};
+  // 只缓存写入文件的目标文件
+  auto use_cache{FCache && !EmitTokens && !EmitAST && !EmitLLVM &&
+                 !OutputAssembly && GetObjOutput(file_name) != "-"};
+
+  std::vector<Token> tokens;
+  // 缓存和 -emit-tokens 需要全部的记号
+  std::unique_ptr<TokenStream> token_stream;
+  if (llvm::sys::path::extension(file_name) == ".i") {
+    auto buffer{llvm::MemoryBuffer::getFile(file_name)};
+    if (!buffer) {
+      Error("can not open file: '{}': {}", file_name,
+            buffer.getError().message());
+    }
+    preprocessed_file = std::move(*buffer);
+    Module().setSourceFileName(file_name);
+
+    auto start{Now()};
+    std::string_view code{preprocessed_file->getBufferStart(),
+                          preprocessed_file->getBufferSize()};
+    auto loc{AddSourceFile(file_name, code)};
+    if (FPipelineLex && !use_cache && !EmitTokens) {
+      token_stream = std::make_unique<TokenStream>(code, loc);
+    } else {
+      tokens = Scanner{code, loc}.Tokenize();
+      PrintLexThroughput(file_name, std::size(code), start);
+    }
+  } else {
+    tokens = preprocessor.Tokenize(file_name);
+  }
+
+  std::string cache_key;
+  if (use_cache) {
+    cache_key = GetCacheKey(file_name, tokens);
+    if (CacheLookup(cache_key, GetObjOutput(file_name))) {
+      return;
+    }
+  }
 
   if (EmitTokens) {
-    if (std::empty(OutputFilePath)) {
+    if (std::empty(OutputFilePath) || OutputFilePath == "-") {
       for (const auto &tok : tokens) {
         if (tok.GetLoc().GetFileName() == file_name) {
           std::cout << tok.ToString() << '\n';
@@ -134,7 +304,8 @@ void RunKcc(const std::string &file_name) {
     return;
   }
 
-  Parser parser{std::move(tokens)};
+  auto parser{token_stream ? Parser{*token_stream}
+                           : Parser{std::move(tokens)}};
   auto unit{parser.ParseTranslationUnit()};
 
   if (EmitAST) {
@@ -149,16 +320,22 @@ void RunKcc(const std::string &file_name) {
 
   CodeGen code_gen;
   code_gen.GenCode(unit);
-  Optimization();
+
+  // -flto 时在链接阶段对合并后的模块统一优化
+  auto emit_bitcode{FLto != LtoKinds::kNone && !EmitLLVM &&
+                    !OutputAssembly};
+  if (!emit_bitcode) {
+    Optimization();
+  }
 
   if (EmitLLVM) {
     std::error_code error_code;
     if (std::empty(OutputFilePath)) {
       llvm::raw_fd_ostream ir_file{GetFileName(file_name, ".ll"), error_code};
-      ir_file << *Module;
+      ir_file << Module();
     } else {
       llvm::raw_fd_ostream ir_file{OutputFilePath, error_code};
-      ir_file << *Module;
+      ir_file << Module();
     }
     return;
   }
@@ -173,16 +350,30 @@ void RunKcc(const std::string &file_name) {
     return;
   }
 
+  auto obj_file{GetObjOutput(file_name)};
+  if (emit_bitcode) {
+    BitcodeGen(obj_file, FLto == LtoKinds::kThin);
+  } else if (ParallelCodegen > 1) {
+    ParallelObjGen(obj_file, ParallelCodegen);
+  } else {
+    ObjGen(obj_file);
+  }
+
+  if (!std::empty(cache_key)) {
+    CacheStore(cache_key, obj_file);
+  }
+}
+
+std::string GetObjOutput(const std::string &file_name) {
   if (OutputObjectFile) {
     if (std::empty(OutputFilePath)) {
-      ObjGen(GetFileName(file_name, ".o"));
+      return GetFileName(file_name, ".o");
     } else {
-      ObjGen(OutputFilePath);
+      return OutputFilePath;
     }
-    return;
   }
 
-  ObjGen(GetObjFile(file_name));
+  return GetObjFile(file_name);
 }
 
 #ifdef DEV
@@ -199,7 +390,7 @@ void Run(const std::string &file) {
   std::ofstream preprocess_file{GetFileName(file, ".i")};
   preprocess_file << preprocessed_code << std::flush;
 
-  Scanner scanner{std::move(preprocessed_code)};
+  Scanner scanner{preprocessed_code};
   auto tokens{scanner.Tokenize()};
   std::ofstream tokens_file{GetFileName(file, ".txt")};
   for (const auto &tok : tokens) {
@@ -220,7 +411,7 @@ void Run(const std::string &file) {
 
   std::error_code error_code;
   llvm::raw_fd_ostream ir_file{GetFileName(file, ".ll"), error_code};
-  ir_file << *Module;
+  ir_file << Module();
 
   cmd = "llc " + GetFileName(file, ".ll");
   if (!CommandSuccess(std::system(cmd.c_str()))) {
@@ -4,10 +4,29 @@
 
 #include "obj_gen.h"
 
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <system_error>
+#include <vector>
 
+#include <lld/Common/Driver.h>
+#include <llvm/ADT/SmallString.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Analysis/ModuleSummaryAnalysis.h>
+#include <llvm/Analysis/ProfileSummaryInfo.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/CodeGen/ParallelCG.h>
 #include <llvm/IR/LegacyPassManager.h>
 #include <llvm/Support/FileSystem.h>
+#include <llvm/Support/FileUtilities.h>
+#include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/raw_ostream.h>
 
 #include "error.h"
@@ -26,11 +45,108 @@ void ObjGen(const std::string &obj_file, llvm::CodeGenFileType file_type) {
   // 定义 PassManager 以生成目标代码
   llvm::legacy::PassManager pass;
 
-  if (TargetMachine->addPassesToEmitFile(pass, dest, nullptr, file_type)) {
+  if (TargetMachine().addPassesToEmitFile(pass, dest, nullptr, file_type)) {
     Error("The TargetMachine can't emit a file of this type");
   }
 
-  pass.run(*Module);
+  pass.run(Module());
+  dest.flush();
+}
+
+void ParallelObjGen(const std::string &obj_file, std::uint32_t partitions) {
+  std::vector<llvm::SmallVector<char, 0>> buffers(partitions);
+  std::vector<std::unique_ptr<llvm::raw_svector_ostream>> streams;
+  std::vector<llvm::raw_pwrite_stream *> os;
+  for (auto &item : buffers) {
+    streams.push_back(std::make_unique<llvm::raw_svector_ostream>(item));
+    os.push_back(streams.back().get());
+  }
+
+  // 保留局部符号, 被同一局部符号引用的全局值会被分到同一个分区中,
+  // 合并后的目标文件与不分区时的符号语义相同
+  llvm::splitCodeGen(Module(), os, {}, CreateTargetMachine,
+                     llvm::CodeGenFileType::CGFT_ObjectFile, true);
+
+  // 各分区的目标文件放在内存文件中, 用 lld -r 合并为一个目标文件
+  std::vector<std::int32_t> fds;
+  std::vector<std::string> paths;
+  for (const auto &item : buffers) {
+    auto fd{memfd_create("kcc-partition", MFD_CLOEXEC)};
+    if (fd == -1) {
+      Error("can not create memory file: {}", std::strerror(errno));
+    }
+
+    llvm::raw_fd_ostream{fd, false} << llvm::StringRef{item.data(),
+                                                        std::size(item)};
+    fds.push_back(fd);
+    paths.push_back("/proc/self/fd/" + std::to_string(fd));
+  }
+
+  // lld 先写 <输出>.tmpXXXX 再重命名覆盖输出, obj_file 可能是
+  // /proc/self/fd 下的内存文件, 所以先输出到真实的临时文件, 再复制过去
+  llvm::SmallString<128> merged;
+  if (auto error_code{
+          llvm::sys::fs::getPotentiallyUniqueTempFileName("kcc-merged", "o",
+                                                          merged)}) {
+    Error("can not create temporary file: '{}'", error_code.message());
+  }
+  llvm::FileRemover remover{merged};
+
+  std::vector<const char *> args{"ld.lld", "-r"};
+  for (const auto &item : paths) {
+    args.push_back(item.c_str());
+  }
+  args.push_back("-o");
+  args.push_back(merged.c_str());
+
+  {
+    // lld 使用了全局状态, 不能同时调用
+    static std::mutex mutex;
+    std::lock_guard lock{mutex};
+    if (!lld::elf::link(args, false, llvm::outs(), llvm::errs())) {
+      Error("can not merge the partitions of '{}'", obj_file);
+    }
+  }
+
+  for (auto fd : fds) {
+    close(fd);
+  }
+
+  auto buffer{llvm::MemoryBuffer::getFile(merged)};
+  if (!buffer) {
+    Error("can not read the merged object file: '{}'",
+          buffer.getError().message());
+  }
+
+  std::error_code error_code;
+  llvm::raw_fd_ostream dest{obj_file, error_code, llvm::sys::fs::F_None};
+  if (error_code) {
+    Error("Could not open file: '{}'", error_code.message());
+  }
+  dest << (*buffer)->getBuffer();
+  dest.close();
+  if (dest.has_error()) {
+    auto message{dest.error().message()};
+    dest.clear_error();
+    Error("can not write file: '{}': {}", obj_file, message);
+  }
+}
+
+void BitcodeGen(const std::string &obj_file, bool with_summary) {
+  std::error_code error_code;
+  llvm::raw_fd_ostream dest{obj_file, error_code, llvm::sys::fs::F_None};
+
+  if (error_code) {
+    Error("Could not open file: '{}'", error_code.message());
+  }
+
+  if (with_summary) {
+    llvm::ProfileSummaryInfo psi{Module()};
+    auto index{llvm::buildModuleSummaryIndex(Module(), nullptr, &psi)};
+    llvm::WriteBitcodeToFile(Module(), dest, false, &index);
+  } else {
+    llvm::WriteBitcodeToFile(Module(), dest);
+  }
   dest.flush();
 }
 
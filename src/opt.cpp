@@ -104,31 +104,31 @@ void Optimization() {
 
     llvm::legacy::PassManager passes;
 
-    llvm::TargetLibraryInfoImpl tlti(llvm::Triple{Module->getTargetTriple()});
+    llvm::TargetLibraryInfoImpl tlti(llvm::Triple{Module().getTargetTriple()});
     passes.add(new llvm::TargetLibraryInfoWrapperPass(tlti));
     passes.add(llvm::createTargetTransformInfoWrapperPass(
-        TargetMachine->getTargetIRAnalysis()));
+        TargetMachine().getTargetIRAnalysis()));
 
     auto fp_passes{
-        std::make_unique<llvm::legacy::FunctionPassManager>(Module.get())};
+        std::make_unique<llvm::legacy::FunctionPassManager>(&Module())};
 
     fp_passes->add(llvm::createTargetTransformInfoWrapperPass(
-        TargetMachine->getTargetIRAnalysis()));
+        TargetMachine().getTargetIRAnalysis()));
 
-    auto &ltm{static_cast<llvm::LLVMTargetMachine &>(*TargetMachine)};
+    auto &ltm{static_cast<llvm::LLVMTargetMachine &>(TargetMachine())};
     passes.add(ltm.createPassConfig(passes));
 
     AddStandardLinkPasses(passes);
-    AddOptimizationPasses(passes, *fp_passes, TargetMachine.get(), level);
+    AddOptimizationPasses(passes, *fp_passes, &TargetMachine(), level);
 
     fp_passes->doInitialization();
-    for (auto &f : *Module) {
+    for (auto &f : Module()) {
       fp_passes->run(f);
     }
     fp_passes->doFinalization();
 
     passes.add(llvm::createVerifierPass());
-    passes.run(*Module);
+    passes.run(Module());
   }
 }
 
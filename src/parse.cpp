@@ -15,15 +15,20 @@
 namespace kcc {
 
 Parser::Parser(std::vector<Token> tokens) : tokens_{std::move(tokens)} {
-  Location loc;
-  loc.SetFileName(Module->getSourceFileName());
-  unit_ = MakeAstNode<TranslationUnit>(loc);
+  // 翻译单元以及内置的声明没有对应的源代码, 只需要文件名
+  unit_ = MakeAstNode<TranslationUnit>(
+      AddSourceFile(Module().getSourceFileName(), {}));
 
   AddBuiltin();
 }
 
+Parser::Parser(TokenStream &stream) : Parser{std::vector<Token>{}} {
+  stream_ = &stream;
+}
+
 TranslationUnit *Parser::ParseTranslationUnit() {
   while (HasNext()) {
+    DiscardTokens();
     unit_->AddExtDecl(ParseExternalDecl());
   }
 
@@ -32,15 +37,33 @@ TranslationUnit *Parser::ParseTranslationUnit() {
 
 bool Parser::HasNext() { return !Peek().TagIs(Tag::kEof); }
 
-const Token &Parser::Peek() { return tokens_[index_]; }
+const Token &Parser::Peek() {
+  if (index_ == std::size(tokens_)) {
+    assert(stream_ != nullptr);
+    stream_->Read(tokens_);
+  }
+
+  return tokens_[index_];
+}
 
-const Token &Parser::Next() { return tokens_[index_++]; }
+const Token &Parser::Next() {
+  Peek();
+  return tokens_[index_++];
+}
 
 void Parser::PutBack() {
   assert(index_ > 0);
   --index_;
 }
 
+// 回溯不会跨越外部声明, 流式读取时丢弃之前的记号
+void Parser::DiscardTokens() {
+  if (stream_ != nullptr) {
+    tokens_.erase(std::begin(tokens_), std::begin(tokens_) + index_);
+    index_ = 0;
+  }
+}
+
 bool Parser::Test(Tag tag) { return Peek().TagIs(tag); }
 
 bool Parser::Try(Tag tag) {
@@ -70,7 +93,10 @@ void Parser::EnterBlock(Type *func_type) {
   }
 }
 
-void Parser::ExitBlock() { scope_ = scope_->GetParent(); }
+void Parser::ExitBlock() {
+  scope_->Exit();
+  scope_ = scope_->GetParent();
+}
 
 void Parser::EnterFunc(IdentifierExpr *ident) {
   func_def_ = MakeAstNode<FuncDef>(ident->GetLoc(), ident);
@@ -80,7 +106,10 @@ void Parser::ExitFunc() { func_def_ = nullptr; }
 
 void Parser::EnterProto() { scope_ = Scope::Get(scope_, kFuncProto); }
 
-void Parser::ExitProto() { scope_ = scope_->GetParent(); }
+void Parser::ExitProto() {
+  scope_->Exit();
+  scope_ = scope_->GetParent();
+}
 
 bool Parser::IsTypeName(const Token &tok) {
   if (tok.IsTypeSpecQual()) {
@@ -119,7 +148,7 @@ std::int64_t Parser::ParseInt64Constant() {
   return val;
 }
 
-LabelStmt *Parser::FindLabel(const std::string &name) const {
+LabelStmt *Parser::FindLabel(Symbol name) const {
   if (auto iter{labels_.find(name)}; iter != std::end(labels_)) {
     return iter->second;
   } else {
@@ -127,7 +156,7 @@ LabelStmt *Parser::FindLabel(const std::string &name) const {
   }
 }
 
-auto Parser::GetStructDesignator(Type *type, const std::string &name)
+auto Parser::GetStructDesignator(Type *type, Symbol name)
     -> decltype(std::begin(type->StructGetMembers())) {
   auto iter{std::begin(type->StructGetMembers())};
 
@@ -137,7 +166,7 @@ auto Parser::GetStructDesignator(Type *type, const std::string &name)
       if (anonymous_type->StructGetMember(name)) {
         return iter;
       }
-    } else if ((*iter)->GetName() == name) {
+    } else if ((*iter)->GetSymbol() == name) {
       return iter;
     }
   }
@@ -150,7 +179,7 @@ Declaration *Parser::MakeDeclaration(const Token &token, QualType type,
                                      std::uint32_t storage_class_spec,
                                      std::uint32_t func_spec,
                                      std::int32_t align) {
-  auto name{token.GetIdentifier()};
+  auto name{token.GetSymbol()};
 
   if (storage_class_spec & kTypedef) {
     if (align > 0) {
@@ -173,7 +202,7 @@ Declaration *Parser::MakeDeclaration(const Token &token, QualType type,
 
       // 如果没有名字, 将 typedef 的名字给该 struct / union
       if (type->IsStructOrUnionTy() && !type->StructHasName()) {
-        type->StructSetName(name);
+        type->StructSetName(name.GetName());
       }
 
       return nullptr;
@@ -185,7 +214,7 @@ Declaration *Parser::MakeDeclaration(const Token &token, QualType type,
   }
 
   if (type->IsVoidTy()) {
-    Error(token, "variable or field '{}' declared void", name);
+    Error(token, "variable or field '{}' declared void", name.GetName());
   } else if (type->IsFunctionTy() && !scope_->IsFileScope()) {
     Error(token, "function declaration is not allowed here");
   }
@@ -210,17 +239,17 @@ Declaration *Parser::MakeDeclaration(const Token &token, QualType type,
     }
 
     if (linkage == Linkage::kNone) {
-      Error(token, "redefinition of '{}'", name);
+      Error(token, "redefinition of '{}'", name.GetName());
     } else if (linkage == Linkage::kExternal) {
       // static int a = 1;
       // extern int a;
       // 这种情况是可以的
       if (ident->GetLinkage() == Linkage::kNone) {
-        Error(token, "conflicting linkage '{}'", name);
+        Error(token, "conflicting linkage '{}'", name.GetName());
       }
     } else {
       if (ident->GetLinkage() != Linkage::kInternal) {
-        Error(token, "conflicting linkage '{}'", name);
+        Error(token, "conflicting linkage '{}'", name.GetName());
       }
     }
 
@@ -269,7 +298,7 @@ Declaration *Parser::MakeDeclaration(const Token &token, QualType type,
     }
 
     type->FuncSetFuncSpec(func_spec);
-    type->FuncSetName(name);
+    type->FuncSetName(name.GetName());
 
     ident = MakeAstNode<IdentifierExpr>(token, name, type, linkage, false);
     scope_->InsertUsual(name, ident);
@@ -316,7 +345,7 @@ ExtDecl *Parser::ParseExternalDecl() {
   TryParseAttributeSpec();
 
   if (Test(Tag::kLeftBrace)) {
-    auto stmt{ext_decl->GetStmts()};
+    const auto &stmt{ext_decl->GetStmts()};
     if (std::size(stmt) != 1) {
       Error(Peek(), "unexpect left braces");
     }
@@ -341,7 +370,7 @@ FuncDef *Parser::ParseFuncDef(const Declaration *decl) {
 
   // label 具有函数作用域
   for (auto &&item : gotos_) {
-    auto label{FindLabel(item->GetName())};
+    auto label{FindLabel(item->GetSymbol())};
     if (label) {
       item->SetLabel(label);
     } else {
@@ -508,7 +537,7 @@ Expr *Parser::ParseOffsetof() {
 
   while (true) {
     token = Expect(Tag::kIdentifier);
-    auto name{token.GetIdentifier()};
+    auto name{token.GetSymbol()};
     auto obj{type->StructGetMember(name)};
 
     if (obj->GetBitFieldWidth()) {
@@ -550,23 +579,25 @@ Expr *Parser::ParseInff() {
 void Parser::AddBuiltin() {
   auto loc{unit_->GetLoc()};
 
-  auto va_list{StructType::Get(true, "__va_list_tag", scope_)};
-  va_list->AddMember(
-      MakeAstNode<ObjectExpr>(loc, "gp_offset", ArithmeticType::Get(kInt)));
-  va_list->AddMember(
-      MakeAstNode<ObjectExpr>(loc, "fp_offset", ArithmeticType::Get(kInt)));
+  auto va_list{StructType::Get(true, "__va_list_tag")};
+  va_list->AddMember(MakeAstNode<ObjectExpr>(loc, Symbol{"gp_offset"},
+                                             ArithmeticType::Get(kInt)));
+  va_list->AddMember(MakeAstNode<ObjectExpr>(loc, Symbol{"fp_offset"},
+                                             ArithmeticType::Get(kInt)));
   va_list->AddMember(MakeAstNode<ObjectExpr>(
-      loc, "overflow_arg_area", PointerType::Get(VoidType::Get())));
+      loc, Symbol{"overflow_arg_area"}, PointerType::Get(VoidType::Get())));
   va_list->AddMember(MakeAstNode<ObjectExpr>(
-      loc, "reg_save_area", PointerType::Get(VoidType::Get())));
+      loc, Symbol{"reg_save_area"}, PointerType::Get(VoidType::Get())));
   va_list->SetComplete(true);
 
-  scope_->InsertUsual(MakeAstNode<IdentifierExpr>(loc, "__builtin_va_list",
-                                                  ArrayType::Get(va_list, 1),
-                                                  Linkage::kNone, true));
+  scope_->InsertUsual(MakeAstNode<IdentifierExpr>(
+      loc, Symbol{"__builtin_va_list"}, ArrayType::Get(va_list, 1),
+      Linkage::kNone, true));
 
-  auto va_list_ptr{MakeAstNode<ObjectExpr>(loc, "", va_list->GetPointerTo())};
-  auto integer{MakeAstNode<ObjectExpr>(loc, "", ArithmeticType::Get(kInt))};
+  auto va_list_ptr{
+      MakeAstNode<ObjectExpr>(loc, Symbol{}, va_list->GetPointerTo())};
+  auto integer{
+      MakeAstNode<ObjectExpr>(loc, Symbol{}, ArithmeticType::Get(kInt))};
 
   auto start{FunctionType::Get(VoidType::Get(), {va_list_ptr, integer})};
   start->SetName("__builtin_va_start");
@@ -578,78 +609,80 @@ void Parser::AddBuiltin() {
   copy->SetName("__builtin_va_copy");
 
   scope_->InsertUsual(MakeAstNode<IdentifierExpr>(
-      loc, "__builtin_va_start", start, Linkage::kExternal, false));
-  scope_->InsertUsual(MakeAstNode<IdentifierExpr>(loc, "__builtin_va_end", end,
-                                                  Linkage::kExternal, false));
+      loc, Symbol{"__builtin_va_start"}, start, Linkage::kExternal, false));
   scope_->InsertUsual(MakeAstNode<IdentifierExpr>(
-      loc, "__builtin_va_arg_sub", arg, Linkage::kExternal, false));
+      loc, Symbol{"__builtin_va_end"}, end, Linkage::kExternal, false));
   scope_->InsertUsual(MakeAstNode<IdentifierExpr>(
-      loc, "__builtin_va_copy", copy, Linkage::kExternal, false));
+      loc, Symbol{"__builtin_va_arg_sub"}, arg, Linkage::kExternal, false));
+  scope_->InsertUsual(MakeAstNode<IdentifierExpr>(
+      loc, Symbol{"__builtin_va_copy"}, copy, Linkage::kExternal, false));
 
   auto sync_synchronize{FunctionType::Get(VoidType::Get(), {})};
   sync_synchronize->FuncSetName("__sync_synchronize");
   scope_->InsertUsual(MakeAstNode<IdentifierExpr>(
-      loc, "__sync_synchronize", sync_synchronize, Linkage::kExternal, false));
+      loc, Symbol{"__sync_synchronize"}, sync_synchronize, Linkage::kExternal,
+      false));
 
-  auto ulong{
-      MakeAstNode<ObjectExpr>(loc, "", ArithmeticType::Get(kLong | kUnsigned))};
+  auto ulong{MakeAstNode<ObjectExpr>(loc, Symbol{},
+                                     ArithmeticType::Get(kLong | kUnsigned))};
   auto alloca{
       FunctionType::Get(ArithmeticType::Get(kChar)->GetPointerTo(), {ulong})};
   alloca->FuncSetName("__builtin_alloca");
   scope_->InsertUsual(MakeAstNode<IdentifierExpr>(
-      loc, "__builtin_alloca", alloca, Linkage::kExternal, false));
+      loc, Symbol{"__builtin_alloca"}, alloca, Linkage::kExternal, false));
 
   auto popcount{FunctionType::Get(ArithmeticType::Get(kInt), {integer})};
   popcount->FuncSetName("__builtin_popcount");
   scope_->InsertUsual(MakeAstNode<IdentifierExpr>(
-      loc, "__builtin_popcount", popcount, Linkage::kExternal, false));
+      loc, Symbol{"__builtin_popcount"}, popcount, Linkage::kExternal, false));
 
   auto clz{FunctionType::Get(ArithmeticType::Get(kInt), {integer})};
   clz->FuncSetName("__builtin_clz");
-  scope_->InsertUsual(MakeAstNode<IdentifierExpr>(loc, "__builtin_clz", clz,
-                                                  Linkage::kExternal, false));
+  scope_->InsertUsual(MakeAstNode<IdentifierExpr>(
+      loc, Symbol{"__builtin_clz"}, clz, Linkage::kExternal, false));
 
   auto ctz{FunctionType::Get(ArithmeticType::Get(kInt), {integer})};
   ctz->FuncSetName("__builtin_ctz");
-  scope_->InsertUsual(MakeAstNode<IdentifierExpr>(loc, "__builtin_ctz", ctz,
-                                                  Linkage::kExternal, false));
+  scope_->InsertUsual(MakeAstNode<IdentifierExpr>(
+      loc, Symbol{"__builtin_ctz"}, ctz, Linkage::kExternal, false));
 
   auto long_integer{
-      MakeAstNode<ObjectExpr>(loc, "", ArithmeticType::Get(kLong))};
+      MakeAstNode<ObjectExpr>(loc, Symbol{}, ArithmeticType::Get(kLong))};
   auto expect{FunctionType::Get(ArithmeticType::Get(kLong),
                                 {long_integer, long_integer})};
   expect->FuncSetName("__builtin_expect");
   scope_->InsertUsual(MakeAstNode<IdentifierExpr>(
-      loc, "__builtin_expect", expect, Linkage::kExternal, false));
+      loc, Symbol{"__builtin_expect"}, expect, Linkage::kExternal, false));
 
   auto float_param{
-      MakeAstNode<ObjectExpr>(loc, "", ArithmeticType::Get(kFloat))};
+      MakeAstNode<ObjectExpr>(loc, Symbol{}, ArithmeticType::Get(kFloat))};
   auto isinf_sign{FunctionType::Get(ArithmeticType::Get(kInt), {float_param})};
   isinf_sign->FuncSetName("__builtin_isinf_sign");
-  scope_->InsertUsual(MakeAstNode<IdentifierExpr>(
-      loc, "__builtin_isinf_sign", isinf_sign, Linkage::kExternal, false));
+  scope_->InsertUsual(
+      MakeAstNode<IdentifierExpr>(loc, Symbol{"__builtin_isinf_sign"},
+                                  isinf_sign, Linkage::kExternal, false));
 
   auto isfinite{FunctionType::Get(ArithmeticType::Get(kInt), {float_param})};
   isfinite->FuncSetName("__builtin_isfinite");
   scope_->InsertUsual(MakeAstNode<IdentifierExpr>(
-      loc, "__builtin_isfinite", isfinite, Linkage::kExternal, false));
+      loc, Symbol{"__builtin_isfinite"}, isfinite, Linkage::kExternal, false));
 
   auto bswap32{FunctionType::Get(ArithmeticType::Get(kInt), {integer})};
   bswap32->FuncSetName("__builtin_bswap32");
   scope_->InsertUsual(MakeAstNode<IdentifierExpr>(
-      loc, "__builtin_bswap32", bswap32, Linkage::kExternal, false));
+      loc, Symbol{"__builtin_bswap32"}, bswap32, Linkage::kExternal, false));
 
   auto bswap64{FunctionType::Get(ArithmeticType::Get(kLong), {long_integer})};
   bswap64->FuncSetName("__builtin_bswap64");
   scope_->InsertUsual(MakeAstNode<IdentifierExpr>(
-      loc, "__builtin_bswap64", bswap64, Linkage::kExternal, false));
+      loc, Symbol{"__builtin_bswap64"}, bswap64, Linkage::kExternal, false));
 
   auto short_integer{
-      MakeAstNode<ObjectExpr>(loc, "", ArithmeticType::Get(kShort))};
+      MakeAstNode<ObjectExpr>(loc, Symbol{}, ArithmeticType::Get(kShort))};
   auto bswap16{FunctionType::Get(ArithmeticType::Get(kShort), {short_integer})};
   bswap16->FuncSetName("__builtin_bswap16");
   scope_->InsertUsual(MakeAstNode<IdentifierExpr>(
-      loc, "__builtin_bswap16", bswap16, Linkage::kExternal, false));
+      loc, Symbol{"__builtin_bswap16"}, bswap16, Linkage::kExternal, false));
 }
 
 }  // namespace kcc
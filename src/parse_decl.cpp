@@ -232,7 +232,7 @@ QualType Parser::ParseDeclSpec(std::uint32_t *storage_class_spec,
 
       default: {
         if (type_spec == 0 && IsTypeName(tok)) {
-          auto ident{scope_->FindUsual(tok.GetIdentifier())};
+          auto ident{scope_->FindUsual(tok)};
           type = ident->GetQualType();
           type_spec |= kTypedefName;
 
@@ -284,16 +284,16 @@ Type *Parser::ParseStructUnionSpec(bool is_struct) {
   TryParseAttributeSpec();
 
   auto tok{Peek()};
-  std::string tag_name;
+  Symbol tag_name;
 
   if (Try(Tag::kIdentifier)) {
-    tag_name = tok.GetIdentifier();
+    tag_name = tok.GetSymbol();
     // 定义
     if (Try(Tag::kLeftBrace)) {
       auto tag{scope_->FindTagInCurrScope(tag_name)};
       // 无前向声明
       if (!tag) {
-        auto type{StructType::Get(is_struct, tag_name, scope_)};
+        auto type{StructType::Get(is_struct, tag_name.GetName())};
         auto ident{MakeAstNode<IdentifierExpr>(tok, tag_name, type)};
         scope_->InsertTag(ident);
 
@@ -302,9 +302,9 @@ Type *Parser::ParseStructUnionSpec(bool is_struct) {
         return type;
       } else {
         if (tag->GetType()->IsComplete()) {
-          Error(tok, "redefinition struct or union :{}", tag_name);
+          Error(tok, "redefinition struct or union :{}", tag_name.GetName());
         } else {
-          ParseStructDeclList(dynamic_cast<StructType *>(tag->GetType()));
+          ParseStructDeclList(tag->GetType()->ToStructType());
 
           Expect(Tag::kRightBrace);
           return tag->GetType();
@@ -317,7 +317,7 @@ Type *Parser::ParseStructUnionSpec(bool is_struct) {
       if (tag) {
         return tag->GetType();
       } else {
-        auto type{StructType::Get(is_struct, tag_name, scope_)};
+        auto type{StructType::Get(is_struct, tag_name.GetName())};
         auto ident{MakeAstNode<IdentifierExpr>(tok, tag_name, type)};
         scope_->InsertTag(ident);
         return type;
@@ -327,7 +327,7 @@ Type *Parser::ParseStructUnionSpec(bool is_struct) {
     // 无标识符只能是定义
     Expect(Tag::kLeftBrace);
 
-    auto type{StructType::Get(is_struct, "", scope_)};
+    auto type{StructType::Get(is_struct, "")};
     ParseStructDeclList(type);
 
     Expect(Tag::kRightBrace);
@@ -338,9 +338,8 @@ Type *Parser::ParseStructUnionSpec(bool is_struct) {
 void Parser::ParseStructDeclList(StructType *type) {
   assert(!type->IsComplete());
 
-  auto scope_backup{scope_};
-  scope_ = type->GetScope();
-
+  // struct / union 中声明的 tag 和枚举常量的作用域与该 struct / union
+  // 所在的作用域相同, 成员保存在 type 中, 因此不需要进入新的作用域
   while (!Test(Tag::kRightBrace)) {
     if (Try(Tag::kStaticAssert)) {
       ParseStaticAssertDecl();
@@ -377,7 +376,7 @@ void Parser::ParseStructDeclList(StructType *type) {
         if (std::empty(tok.GetStr())) {
           // 此时该 struct / union 不能有名字
           if (copy->IsStructOrUnionTy() && !copy->StructHasName()) {
-            auto anonymous{MakeAstNode<ObjectExpr>(tok, "", copy, 0,
+            auto anonymous{MakeAstNode<ObjectExpr>(tok, Symbol{}, copy, 0,
                                                    Linkage::kNone, true)};
             type->MergeAnonymous(anonymous);
             continue;
@@ -385,10 +384,10 @@ void Parser::ParseStructDeclList(StructType *type) {
             Error(Peek(), "declaration does not declare anything");
           }
         } else {
-          auto name{tok.GetIdentifier()};
+          auto name{tok.GetSymbol()};
 
           if (type->GetMember(name)) {
-            Error(Peek(), "duplicate member: '{}'", name);
+            Error(Peek(), "duplicate member: '{}'", name.GetName());
           } else if (copy->IsArrayTy() && !copy->IsComplete()) {
             // 可能是柔性数组
             // 若结构体定义了至少一个具名成员,
@@ -400,10 +399,10 @@ void Parser::ParseStructDeclList(StructType *type) {
 
               goto finalize;
             } else {
-              Error(Peek(), "field '{}' has incomplete type", name);
+              Error(Peek(), "field '{}' has incomplete type", name.GetName());
             }
           } else if (copy->IsFunctionTy()) {
-            Error(Peek(), "field '{}' declared as a function", name);
+            Error(Peek(), "field '{}' declared as a function", name.GetName());
           } else {
             auto member{MakeAstNode<ObjectExpr>(tok, name, copy)};
             type->AddMember(member);
@@ -419,17 +418,6 @@ finalize:
   TryParseAttributeSpec();
 
   type->SetComplete(true);
-
-  // struct / union 中的 tag 的作用域与该 struct / union 所在的作用域相同
-  for (const auto &[name, tag] : scope_->AllTagInCurrScope()) {
-    if (scope_backup->FindTagInCurrScope(name)) {
-      Error(tag->GetLoc(), "redefinition of tag {}", tag->GetName());
-    } else {
-      scope_backup->InsertTag(name, tag);
-    }
-  }
-
-  scope_ = scope_backup;
 }
 
 void Parser::ParseBitField(StructType *type, const Token &tok,
@@ -457,13 +445,13 @@ void Parser::ParseBitField(StructType *type, const Token &tok,
 
   ObjectExpr *bit_field;
   if (std::empty(tok.GetStr())) {
-    bit_field = MakeAstNode<ObjectExpr>(tok, "", member_type, 0, Linkage::kNone,
-                                        true, width);
+    bit_field = MakeAstNode<ObjectExpr>(tok, Symbol{}, member_type, 0,
+                                        Linkage::kNone, true, width);
   } else {
-    auto name{tok.GetIdentifier()};
+    auto name{tok.GetSymbol()};
 
     if (type->GetMember(name)) {
-      Error(tok, "duplicate member: '{}'", name);
+      Error(tok, "duplicate member: '{}'", name.GetName());
     }
 
     bit_field = MakeAstNode<ObjectExpr>(tok, name, member_type, 0,
@@ -476,11 +464,11 @@ void Parser::ParseBitField(StructType *type, const Token &tok,
 Type *Parser::ParseEnumSpec() {
   TryParseAttributeSpec();
 
-  std::string tag_name;
+  Symbol tag_name;
   auto tok{Peek()};
 
   if (Try(Tag::kIdentifier)) {
-    tag_name = tok.GetIdentifier();
+    tag_name = tok.GetSymbol();
     // 定义
     if (Try(Tag::kLeftBrace)) {
       auto tag{scope_->FindTagInCurrScope(tag_name)};
@@ -495,7 +483,7 @@ Type *Parser::ParseEnumSpec() {
         return type;
       } else {
         // 不允许前向声明，如果当前作用域中有 tag 则就是重定义
-        Error(tok, "redefinition of enumeration tag: {}", tag_name);
+        Error(tok, "redefinition of enumeration tag: {}", tag_name.GetName());
       }
     } else {
       // 只能是普通声明
@@ -503,7 +491,7 @@ Type *Parser::ParseEnumSpec() {
       if (tag) {
         return tag->GetType();
       } else {
-        Error(tok, "unknown enumeration: {}", tag_name);
+        Error(tok, "unknown enumeration: {}", tag_name.GetName());
       }
     }
   } else {
@@ -521,11 +509,11 @@ void Parser::ParseEnumerator() {
     auto tok{Expect(Tag::kIdentifier)};
     TryParseAttributeSpec();
 
-    auto name{tok.GetIdentifier()};
+    auto name{tok.GetSymbol()};
     auto ident{scope_->FindUsualInCurrScope(name)};
 
     if (ident) {
-      Error(tok, "redefinition of enumerator '{}'", name);
+      Error(tok, "redefinition of enumerator '{}'", name.GetName());
     }
 
     if (Try(Tag::kEqual)) {
@@ -533,7 +521,7 @@ void Parser::ParseEnumerator() {
       val = *CalcConstantExpr{}.CalcInteger(expr);
     }
 
-    auto enumer{MakeAstNode<EnumeratorExpr>(tok, tok.GetIdentifier(), val)};
+    auto enumer{MakeAstNode<EnumeratorExpr>(tok, name, val)};
     ++val;
     scope_->InsertUsual(name, enumer);
 
@@ -796,7 +784,8 @@ ObjectExpr *Parser::ParseParamDecl() {
   base_type = Type::MayCast(base_type);
 
   if (std::empty(tok.GetStr())) {
-    return MakeAstNode<ObjectExpr>(tok, "", base_type, 0, Linkage::kNone, true);
+    return MakeAstNode<ObjectExpr>(tok, Symbol{}, base_type, 0, Linkage::kNone,
+                                   true);
   }
 
   auto decl{MakeDeclaration(tok, base_type, 0, 0, 0)};
@@ -15,6 +15,46 @@
 
 namespace kcc {
 
+namespace {
+
+// 不是二元运算符 (不包括逗号和赋值) 时返回 0
+std::int32_t BinaryOpPrecedence(Tag tag) {
+  switch (tag) {
+    case Tag::kPipePipe:
+      return 1;
+    case Tag::kAmpAmp:
+      return 2;
+    case Tag::kPipe:
+      return 3;
+    case Tag::kCaret:
+      return 4;
+    case Tag::kAmp:
+      return 5;
+    case Tag::kEqualEqual:
+    case Tag::kExclaimEqual:
+      return 6;
+    case Tag::kLess:
+    case Tag::kGreater:
+    case Tag::kLessEqual:
+    case Tag::kGreaterEqual:
+      return 7;
+    case Tag::kLessLess:
+    case Tag::kGreaterGreater:
+      return 8;
+    case Tag::kPlus:
+    case Tag::kMinus:
+      return 9;
+    case Tag::kStar:
+    case Tag::kSlash:
+    case Tag::kPercent:
+      return 10;
+    default:
+      return 0;
+  }
+}
+
+}  // namespace
+
 /*
  * Expr
  */
@@ -95,7 +135,7 @@ Expr *Parser::ParseAssignExpr() {
 }
 
 Expr *Parser::ParseConditionExpr() {
-  auto cond{ParseLogicalOrExpr()};
+  auto cond{ParseBinaryExpr()};
 
   auto token{Peek()};
   if (Try(Tag::kQuestion)) {
@@ -111,175 +151,21 @@ Expr *Parser::ParseConditionExpr() {
   return cond;
 }
 
-Expr *Parser::ParseLogicalOrExpr() {
-  auto lhs{ParseLogicalAndExpr()};
-
-  auto token{Peek()};
-  while (Try(Tag::kPipePipe)) {
-    auto rhs{ParseLogicalAndExpr()};
-    lhs = MakeAstNode<BinaryOpExpr>(token, Tag::kPipePipe, lhs, rhs);
-    token = Peek();
-  }
-
-  return lhs;
-}
-
-Expr *Parser::ParseLogicalAndExpr() {
-  auto lhs{ParseInclusiveOrExpr()};
-
-  auto token{Peek()};
-  while (Try(Tag::kAmpAmp)) {
-    auto rhs{ParseInclusiveOrExpr()};
-    lhs = MakeAstNode<BinaryOpExpr>(token, Tag::kAmpAmp, lhs, rhs);
-    token = Peek();
-  }
-
-  return lhs;
-}
-
-Expr *Parser::ParseInclusiveOrExpr() {
-  auto lhs{ParseExclusiveOrExpr()};
-
-  auto token{Peek()};
-  while (Try(Tag::kPipe)) {
-    auto rhs{ParseExclusiveOrExpr()};
-    lhs = MakeAstNode<BinaryOpExpr>(token, Tag::kPipe, lhs, rhs);
-    token = Peek();
-  }
-
-  return lhs;
-}
-
-Expr *Parser::ParseExclusiveOrExpr() {
-  auto lhs{ParseAndExpr()};
-
-  auto token{Peek()};
-  while (Try(Tag::kCaret)) {
-    auto rhs{ParseAndExpr()};
-    lhs = MakeAstNode<BinaryOpExpr>(token, Tag::kCaret, lhs, rhs);
-    token = Peek();
-  }
-
-  return lhs;
-}
-
-Expr *Parser::ParseAndExpr() {
-  auto lhs{ParseEqualityExpr()};
-
-  auto token{Peek()};
-  while (Try(Tag::kAmp)) {
-    auto rhs{ParseEqualityExpr()};
-    lhs = MakeAstNode<BinaryOpExpr>(token, Tag::kAmp, lhs, rhs);
-    token = Peek();
-  }
-
-  return lhs;
-}
-
-Expr *Parser::ParseEqualityExpr() {
-  auto lhs{ParseRelationExpr()};
-
-  auto token{Peek()};
-  while (true) {
-    if (Try(Tag::kEqualEqual)) {
-      auto rhs{ParseRelationExpr()};
-      lhs = MakeAstNode<BinaryOpExpr>(token, Tag::kEqualEqual, lhs, rhs);
-    } else if (Try(Tag::kExclaimEqual)) {
-      auto rhs{ParseRelationExpr()};
-      lhs = MakeAstNode<BinaryOpExpr>(token, Tag::kExclaimEqual, lhs, rhs);
-    } else {
-      break;
-    }
-    token = Peek();
-  }
-
-  return lhs;
-}
-
-Expr *Parser::ParseRelationExpr() {
-  auto lhs{ParseShiftExpr()};
-
-  auto token{Peek()};
-  while (true) {
-    if (Try(Tag::kLess)) {
-      auto rhs{ParseShiftExpr()};
-      lhs = MakeAstNode<BinaryOpExpr>(token, Tag::kLess, lhs, rhs);
-    } else if (Try(Tag::kGreater)) {
-      auto rhs{ParseShiftExpr()};
-      lhs = MakeAstNode<BinaryOpExpr>(token, Tag::kGreater, lhs, rhs);
-    } else if (Try(Tag::kLessEqual)) {
-      auto rhs{ParseShiftExpr()};
-      lhs = MakeAstNode<BinaryOpExpr>(token, Tag::kLessEqual, lhs, rhs);
-    } else if (Try(Tag::kGreaterEqual)) {
-      auto rhs{ParseShiftExpr()};
-      lhs = MakeAstNode<BinaryOpExpr>(token, Tag::kGreaterEqual, lhs, rhs);
-    } else {
-      break;
-    }
-    token = Peek();
-  }
-
-  return lhs;
-}
-
-Expr *Parser::ParseShiftExpr() {
-  auto lhs{ParseAdditiveExpr()};
-
-  auto token{Peek()};
-  while (true) {
-    if (Try(Tag::kLessLess)) {
-      auto rhs{ParseAdditiveExpr()};
-      lhs = MakeAstNode<BinaryOpExpr>(token, Tag::kLessLess, lhs, rhs);
-    } else if (Try(Tag::kGreaterGreater)) {
-      auto rhs{ParseAdditiveExpr()};
-      lhs = MakeAstNode<BinaryOpExpr>(token, Tag::kGreaterGreater, lhs, rhs);
-    } else {
-      break;
-    }
-    token = Peek();
-  }
-
-  return lhs;
-}
-
-Expr *Parser::ParseAdditiveExpr() {
-  auto lhs{ParseMultiplicativeExpr()};
-
-  auto token{Peek()};
-  while (true) {
-    if (Try(Tag::kPlus)) {
-      auto rhs{ParseMultiplicativeExpr()};
-      lhs = MakeAstNode<BinaryOpExpr>(token, Tag::kPlus, lhs, rhs);
-    } else if (Try(Tag::kMinus)) {
-      auto rhs{ParseMultiplicativeExpr()};
-      lhs = MakeAstNode<BinaryOpExpr>(token, Tag::kMinus, lhs, rhs);
-    } else {
-      break;
-    }
-    token = Peek();
-  }
-
-  return lhs;
-}
-
-Expr *Parser::ParseMultiplicativeExpr() {
+// 优先级爬升, 只有 min_prec 及以上优先级的运算符才会结合到 lhs
+// 二元运算符都是左结合的, 因此右运算数只结合更高优先级的运算符
+Expr *Parser::ParseBinaryExpr(std::int32_t min_prec) {
   auto lhs{ParseCastExpr()};
 
-  auto token{Peek()};
   while (true) {
-    if (Try(Tag::kStar)) {
-      auto rhs{ParseCastExpr()};
-      lhs = MakeAstNode<BinaryOpExpr>(token, Tag::kStar, lhs, rhs);
-    } else if (Try(Tag::kSlash)) {
-      auto rhs{ParseCastExpr()};
-      lhs = MakeAstNode<BinaryOpExpr>(token, Tag::kSlash, lhs, rhs);
-    } else if (Try(Tag::kPercent)) {
-      auto rhs{ParseCastExpr()};
-      lhs = MakeAstNode<BinaryOpExpr>(token, Tag::kPercent, lhs, rhs);
-    } else {
+    auto token{Peek()};
+    auto prec{BinaryOpPrecedence(token.GetTag())};
+    if (prec < min_prec) {
       break;
     }
-    token = Peek();
+
+    Next();
+    auto rhs{ParseBinaryExpr(prec + 1)};
+    lhs = MakeAstNode<BinaryOpExpr>(token, token.GetTag(), lhs, rhs);
   }
 
   return lhs;
@@ -412,8 +298,8 @@ Expr *Parser::TryParseCompoundLiteral() {
 
 Expr *Parser::ParseCompoundLiteral(QualType type) {
   if (scope_->IsFileScope()) {
-    auto obj{
-        MakeAstNode<ObjectExpr>(Peek(), "", type, 0, Linkage::kInternal, true)};
+    auto obj{MakeAstNode<ObjectExpr>(Peek(), Symbol{}, type, 0,
+                                     Linkage::kInternal, true)};
     auto decl{MakeAstNode<Declaration>(Peek(), obj)};
 
     decl->SetConstant(
@@ -423,8 +309,8 @@ Expr *Parser::ParseCompoundLiteral(QualType type) {
 
     return obj;
   } else {
-    auto obj{MakeAstNode<ObjectExpr>(Peek(), ".compoundliteral", type, 0,
-                                     Linkage::kNone, true)};
+    auto obj{MakeAstNode<ObjectExpr>(Peek(), Symbol{".compoundliteral"}, type,
+                                     0, Linkage::kNone, true)};
     auto decl{MakeAstNode<Declaration>(Peek(), obj)};
 
     ParseInitDeclaratorSub(decl);
@@ -505,7 +391,7 @@ Expr *Parser::ParseMemberRefExpr(Expr *expr) {
   auto token{Peek()};
 
   auto member{Expect(Tag::kIdentifier)};
-  auto member_name{member.GetIdentifier()};
+  auto member_name{member.GetSymbol()};
 
   auto type{expr->GetQualType()};
   if (!type->IsStructOrUnionTy()) {
@@ -514,14 +400,14 @@ Expr *Parser::ParseMemberRefExpr(Expr *expr) {
 
   auto rhs{type->StructGetMember(member_name)};
   if (!rhs) {
-    Error(member, "'{}' is not a member of '{}'", member_name,
+    Error(member, "'{}' is not a member of '{}'", member_name.GetName(),
           type->StructGetName());
   }
 
   // 当函数返回一个 struct / union 时
   if (expr->Kind() == AstNodeType::kFuncCallExpr) {
-    auto obj{
-        MakeAstNode<ObjectExpr>(Peek(), "", type, 0, Linkage::kNone, true)};
+    auto obj{MakeAstNode<ObjectExpr>(Peek(), Symbol{}, type, 0, Linkage::kNone,
+                                     true)};
     auto decl{MakeAstNode<Declaration>(Peek(), obj)};
 
     std::vector<Initializer> inits;
@@ -547,13 +433,13 @@ Expr *Parser::ParsePrimaryExpr() {
   }
 
   if (Peek().IsIdentifier()) {
-    auto name{Next().GetIdentifier()};
+    auto name{Next().GetSymbol()};
     auto ident{scope_->FindUsual(name)};
 
     if (ident) {
       return ident;
     } else {
-      Error(token, "undefined symbol: {}", name);
+      Error(token, "undefined symbol: {}", name.GetName());
     }
   } else if (Peek().IsConstant()) {
     return ParseConstant();
@@ -634,7 +520,7 @@ Expr *Parser::ParseCharacter() {
 
 Expr *Parser::ParseInteger() {
   auto token{Next()};
-  auto str{token.GetStr()};
+  std::string str{token.GetStr()};
   std::uint64_t val;
   std::size_t end;
 
@@ -747,7 +633,7 @@ Expr *Parser::ParseInteger() {
 
 Expr *Parser::ParseFloat() {
   auto tok{Next()};
-  auto str{tok.GetStr()};
+  std::string str{tok.GetStr()};
   long double val;
   std::size_t end;
 
@@ -151,10 +151,10 @@ void Parser::ParseStructInitializer(std::vector<Initializer> &inits, Type *type,
 
     if ((designated = Try(Tag::kPeriod))) {
       auto tok{Expect(Tag::kIdentifier)};
-      auto name{tok.GetIdentifier()};
+      auto name{tok.GetSymbol()};
 
       if (!type->StructGetMember(name)) {
-        Error(tok, "member '{}' not found", name);
+        Error(tok, "member '{}' not found", name.GetName());
       }
 
       member_iter = GetStructDesignator(type, name);
@@ -360,10 +360,10 @@ llvm::Constant *Parser::ParseConstantStructInitializer(Type *type,
 
     if ((designated = Try(Tag::kPeriod))) {
       auto tok{Expect(Tag::kIdentifier)};
-      auto name{tok.GetIdentifier()};
+      auto name{tok.GetSymbol()};
 
       if (!type->StructGetMember(name)) {
-        Error(tok, "member '{}' not found", name);
+        Error(tok, "member '{}' not found", name.GetName());
       }
 
       member_iter = GetStructDesignator(type, name);
@@ -387,7 +387,7 @@ llvm::Constant *Parser::ParseConstantStructInitializer(Type *type,
 
     if (width) {
       llvm::Constant *old_value{
-          llvm::ConstantInt::get(Builder.getInt32Ty(), 0)};
+          llvm::ConstantInt::get(Builder().getInt32Ty(), 0)};
 
       if (member_type->isArrayTy()) {
         auto arr{val[index]};
@@ -396,16 +396,16 @@ llvm::Constant *Parser::ParseConstantStructInitializer(Type *type,
               old_value,
               llvm::ConstantExpr::getShl(
                   llvm::ConstantExpr::getZExt(arr->getAggregateElement(i),
-                                              Builder.getInt32Ty()),
-                  llvm::ConstantInt::get(Builder.getInt32Ty(), i * 8)));
+                                              Builder().getInt32Ty()),
+                  llvm::ConstantInt::get(Builder().getInt32Ty(), i * 8)));
         }
       } else {
         if ((*member_iter)->GetType()->IsUnsigned()) {
           old_value =
-              llvm::ConstantExpr::getZExt(val[index], Builder.getInt32Ty());
+              llvm::ConstantExpr::getZExt(val[index], Builder().getInt32Ty());
         } else {
           old_value =
-              llvm::ConstantExpr::getSExt(val[index], Builder.getInt32Ty());
+              llvm::ConstantExpr::getSExt(val[index], Builder().getInt32Ty());
         }
       }
 
@@ -416,7 +416,7 @@ llvm::Constant *Parser::ParseConstantStructInitializer(Type *type,
                                               designated, false)};
 
       new_value = llvm::ConstantExpr::getShl(
-          new_value, llvm::ConstantInt::get(Builder.getInt32Ty(), begin));
+          new_value, llvm::ConstantInt::get(Builder().getInt32Ty(), begin));
       new_value = llvm::ConstantExpr::getOr(old_value, new_value);
 
       if (member_type->isArrayTy()) {
@@ -424,16 +424,16 @@ llvm::Constant *Parser::ParseConstantStructInitializer(Type *type,
         auto arr_size{member_type->getArrayNumElements()};
         for (std::size_t i{}; i < arr_size; ++i) {
           auto temp{
-              llvm::ConstantExpr::getTrunc(new_value, Builder.getInt8Ty())};
+              llvm::ConstantExpr::getTrunc(new_value, Builder().getInt8Ty())};
           v.push_back(temp);
           new_value = llvm::ConstantExpr::getLShr(
-              new_value, llvm::ConstantInt::get(Builder.getInt32Ty(), 8));
+              new_value, llvm::ConstantInt::get(Builder().getInt32Ty(), 8));
         }
         val[index] = llvm::ConstantArray::get(
             llvm::cast<llvm::ArrayType>(member_type), v);
       } else {
         val[index] =
-            llvm::ConstantExpr::getTrunc(new_value, Builder.getInt8Ty());
+            llvm::ConstantExpr::getTrunc(new_value, Builder().getInt8Ty());
       }
     } else {
       // 当 union 类型不对时应该新创建一个类型, 并替换
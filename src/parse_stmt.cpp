@@ -60,9 +60,9 @@ Stmt *Parser::ParseLabelStmt() {
 
   TryParseAttributeSpec();
 
-  auto name{token.GetIdentifier()};
+  auto name{token.GetSymbol()};
   if (FindLabel(name)) {
-    Error(token, "redefine of label: '{}'", token.GetIdentifier());
+    Error(token, "redefine of label: '{}'", name.GetName());
   }
 
   auto label{MakeAstNode<LabelStmt>(token, name, ParseStmt())};
@@ -212,7 +212,7 @@ Stmt *Parser::ParseGotoStmt() {
   auto tok{Expect(Tag::kIdentifier)};
   Expect(Tag::kSemicolon);
 
-  auto ret{MakeAstNode<GotoStmt>(tok, tok.GetIdentifier())};
+  auto ret{MakeAstNode<GotoStmt>(tok, tok.GetSymbol())};
   gotos_.push_back(ret);
 
   return ret;
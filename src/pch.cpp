@@ -0,0 +1,268 @@
+//
+// Created by kaiser on 2026/10/16.
+//
+
+#include "pch.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+#include "error.h"
+#include "location.h"
+
+namespace kcc {
+
+namespace {
+
+constexpr std::string_view Magic{"KCCPCH04"};
+
+class Writer {
+ public:
+  explicit Writer(std::ofstream &ofs) : ofs_{ofs} {}
+
+  template <typename T>
+  void Write(T value) {
+    ofs_.write(reinterpret_cast<const char *>(&value), sizeof(value));
+  }
+
+  void Write(std::string_view str) {
+    Write(static_cast<std::uint32_t>(std::size(str)));
+    ofs_.write(str.data(), std::size(str));
+  }
+
+  void Write(const std::string &str) { Write(std::string_view{str}); }
+
+ private:
+  std::ofstream &ofs_;
+};
+
+class Reader {
+ public:
+  Reader(const std::string &file_name, std::string_view data)
+      : file_name_{file_name}, data_{data} {}
+
+  template <typename T>
+  T Read() {
+    T value;
+    std::memcpy(&value, Take(sizeof(value)), sizeof(value));
+    return value;
+  }
+
+  Tag ReadTag() {
+    auto tag{Read<std::underlying_type_t<Tag>>()};
+    if (tag > static_cast<std::underlying_type_t<Tag>>(Tag::kEof)) {
+      Error("invalid precompiled header: '{}'", file_name_);
+    }
+    return static_cast<Tag>(tag);
+  }
+
+  std::string ReadString() {
+    auto size{Read<std::uint32_t>()};
+    return std::string(Take(size), size);
+  }
+
+ private:
+  const char *Take(std::size_t size) {
+    if (std::size(data_) - index_ < size) {
+      Error("invalid precompiled header: '{}'", file_name_);
+    }
+
+    auto p{data_.data() + index_};
+    index_ += size;
+    return p;
+  }
+
+  const std::string &file_name_;
+  std::string_view data_;
+  std::size_t index_{};
+};
+
+}  // namespace
+
+void PchFile::Write(const std::string &file_name) const {
+  std::ofstream ofs{file_name, std::ios::binary};
+  if (!ofs) {
+    Error("can not open file: '{}'", file_name);
+  }
+
+  ofs.write(Magic.data(), std::size(Magic));
+
+  Writer writer{ofs};
+  writer.Write(std::string_view{KCC_VERSION});
+  writer.Write(header);
+  writer.Write(options);
+
+  writer.Write(static_cast<std::uint32_t>(std::size(dependencies)));
+  for (const auto &item : dependencies) {
+    writer.Write(item.name);
+    writer.Write(item.size);
+    writer.Write(item.time);
+  }
+
+  writer.Write(static_cast<std::uint32_t>(std::size(names)));
+  for (const auto &item : names) {
+    writer.Write(item);
+  }
+
+  writer.Write(static_cast<std::uint32_t>(std::size(contents)));
+  for (const auto &item : contents) {
+    writer.Write(item);
+  }
+
+  writer.Write(static_cast<std::uint32_t>(std::size(markers)));
+  for (const auto &item : markers) {
+    writer.Write(item.file);
+    writer.Write(item.offset);
+    writer.Write(item.name);
+    writer.Write(item.row);
+  }
+
+  writer.Write(macros);
+
+  writer.Write(static_cast<std::uint32_t>(std::size(tokens)));
+  for (const auto &item : tokens) {
+    writer.Write(item.tag);
+    writer.Write(item.str);
+    writer.Write(item.file);
+    writer.Write(item.offset);
+  }
+
+  if (!ofs.flush()) {
+    Error("can not write file: '{}'", file_name);
+  }
+}
+
+void PchFile::Read(const std::string &file_name) {
+  std::ifstream ifs{file_name, std::ios::binary};
+  if (!ifs) {
+    Error("can not open file: '{}'", file_name);
+  }
+
+  std::string data{std::istreambuf_iterator<char>{ifs},
+                   std::istreambuf_iterator<char>{}};
+  if (!std::string_view{data}.starts_with(Magic)) {
+    Error("not a precompiled header: '{}'", file_name);
+  }
+
+  Reader reader{file_name, std::string_view{data}.substr(std::size(Magic))};
+  if (reader.ReadString() != KCC_VERSION) {
+    Error("precompiled header '{}' was built by a different version of kcc",
+          file_name);
+  }
+
+  header = reader.ReadString();
+  options = reader.ReadString();
+
+  dependencies.resize(reader.Read<std::uint32_t>());
+  for (auto &item : dependencies) {
+    item.name = reader.ReadString();
+    item.size = reader.Read<std::uint64_t>();
+    item.time = reader.Read<std::int64_t>();
+  }
+
+  names.resize(reader.Read<std::uint32_t>());
+  for (auto &item : names) {
+    item = reader.ReadString();
+  }
+
+  contents.resize(reader.Read<std::uint32_t>());
+  for (auto &item : contents) {
+    item = reader.ReadString();
+  }
+
+  // 每个文件都需要有行标记, 第一个行标记即为文件本身
+  std::vector<bool> has_marker(std::size(contents));
+  markers.resize(reader.Read<std::uint32_t>());
+  for (auto &item : markers) {
+    item.file = reader.Read<std::uint32_t>();
+    item.offset = reader.Read<std::uint32_t>();
+    item.name = reader.Read<std::uint32_t>();
+    item.row = reader.Read<std::int32_t>();
+
+    if (item.file >= std::size(contents) || item.name >= std::size(names) ||
+        item.offset > std::size(contents[item.file]) ||
+        (!has_marker[item.file] && item.offset != 0)) {
+      Error("invalid precompiled header: '{}'", file_name);
+    }
+    has_marker[item.file] = true;
+  }
+
+  if (std::find(std::begin(has_marker), std::end(has_marker), false) !=
+      std::end(has_marker)) {
+    Error("invalid precompiled header: '{}'", file_name);
+  }
+
+  macros = reader.ReadString();
+
+  tokens.resize(reader.Read<std::uint32_t>());
+  for (auto &item : tokens) {
+    item.tag = reader.ReadTag();
+    item.str = reader.ReadString();
+    item.file = reader.Read<std::uint32_t>();
+    item.offset = reader.Read<std::uint32_t>();
+
+    if (item.file >= std::size(contents) ||
+        item.offset > std::size(contents[item.file])) {
+      Error("invalid precompiled header: '{}'", file_name);
+    }
+  }
+}
+
+bool PchFile::IsUpToDate(const std::string &options) const {
+  if (options != this->options) {
+    return false;
+  }
+
+  for (const auto &item : dependencies) {
+    std::error_code error_code;
+    auto size{std::filesystem::file_size(item.name, error_code)};
+    if (error_code || size != item.size) {
+      return false;
+    }
+
+    auto time{std::filesystem::last_write_time(item.name, error_code)};
+    if (error_code || time.time_since_epoch().count() != item.time) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// 记号的位置指向 contents 中的文件内容, 使用记号时 PchFile 必须存在
+std::vector<Token> PchFile::GetTokens() const {
+  std::vector<Location> files(std::size(contents));
+  for (const auto &item : markers) {
+    if (auto &loc{files[item.file]}; !loc.IsValid()) {
+      loc = AddSourceFile(names[item.name], contents[item.file]);
+    } else {
+      AddLineMarker(loc.GetLocWithOffset(item.offset), names[item.name],
+                    item.row);
+    }
+  }
+
+  std::vector<Token> result;
+  result.reserve(std::size(tokens));
+
+  for (const auto &item : tokens) {
+    Token token;
+    token.SetTag(item.tag);
+    if (token.IsIdentifier()) {
+      token.SetSymbol(Symbol{item.str});
+    } else {
+      token.SetStr(item.str);
+    }
+    token.SetLoc(files[item.file].GetLocWithOffset(item.offset));
+    result.push_back(token);
+  }
+
+  return result;
+}
+
+}  // namespace kcc
@@ -4,73 +4,63 @@
 
 #include "scope.h"
 
-#include "memory_pool.h"
+#include <cassert>
+
+#include "arena.h"
 
 namespace kcc {
 
 Scope *Scope::Get(Scope *parent, enum ScopeType type) {
-  return new (ScopePool.malloc()) Scope{parent, type};
+  return new (AstArena().Allocate<Scope>()) Scope{parent, type};
+}
+
+void Scope::Exit() {
+  assert(type_ != kFile);
+
+  auto &log{table_->log};
+  assert(std::size(log) >= log_begin_);
+
+  while (std::size(log) > log_begin_) {
+    assert(log.back()->back().scope == this);
+    log.back()->pop_back();
+    log.pop_back();
+  }
 }
 
 void Scope::InsertTag(IdentifierExpr *ident) {
-  InsertTag(ident->GetName(), ident);
+  InsertTag(ident->GetSymbol(), ident);
 }
 
 void Scope::InsertUsual(IdentifierExpr *ident) {
-  InsertUsual(ident->GetName(), ident);
+  InsertUsual(ident->GetSymbol(), ident);
 }
 
-void Scope::InsertTag(const std::string &name, IdentifierExpr *ident) {
-  tags_[name] = ident;
+void Scope::InsertTag(Symbol name, IdentifierExpr *ident) {
+  Insert(table_->tags, name, ident);
 }
 
-void Scope::InsertUsual(const std::string &name, IdentifierExpr *ident) {
-  usual_[name] = ident;
+void Scope::InsertUsual(Symbol name, IdentifierExpr *ident) {
+  Insert(table_->usual, name, ident);
 }
 
-IdentifierExpr *Scope::FindTag(const std::string &name) {
-  auto iter{tags_.find(name)};
-  if (iter != std::end(tags_)) {
-    return iter->second;
-  }
-
-  if (type_ == kFile || parent_ == nullptr) {
-    return nullptr;
-  } else {
-    return parent_->FindTag(name);
-  }
+IdentifierExpr *Scope::FindTag(Symbol name) {
+  return Find(table_->tags, name);
 }
 
-IdentifierExpr *Scope::FindUsual(const std::string &name) {
-  auto iter{usual_.find(name)};
-  if (iter != std::end(usual_)) {
-    return iter->second;
-  }
-
-  if (type_ == kFile || parent_ == nullptr) {
-    return nullptr;
-  } else {
-    return parent_->FindUsual(name);
-  }
+IdentifierExpr *Scope::FindUsual(Symbol name) {
+  return Find(table_->usual, name);
 }
 
-IdentifierExpr *Scope::FindTagInCurrScope(const std::string &name) {
-  auto iter{tags_.find(name)};
-  return iter == std::end(tags_) ? nullptr : iter->second;
+IdentifierExpr *Scope::FindTagInCurrScope(Symbol name) {
+  return FindInCurrScope(table_->tags, name);
 }
 
-IdentifierExpr *Scope::FindUsualInCurrScope(const std::string &name) {
-  auto iter{usual_.find(name)};
-  return iter == std::end(usual_) ? nullptr : iter->second;
+IdentifierExpr *Scope::FindUsualInCurrScope(Symbol name) {
+  return FindInCurrScope(table_->usual, name);
 }
 
 IdentifierExpr *Scope::FindUsual(const Token &tok) {
-  return FindUsual(tok.GetIdentifier());
-}
-
-std::unordered_map<std::string, IdentifierExpr *> Scope::AllTagInCurrScope()
-    const {
-  return tags_;
+  return FindUsual(tok.GetSymbol());
 }
 
 Scope *Scope::GetParent() { return parent_; }
@@ -80,6 +70,41 @@ bool Scope::IsFileScope() const { return type_ == kFile; }
 bool Scope::IsBlockScope() const { return type_ == kBlock; }
 
 Scope::Scope(Scope *parent, enum ScopeType type)
-    : parent_{parent}, type_{type} {}
+    : parent_{parent},
+      type_{type},
+      table_{parent ? parent->table_
+                    : new (AstArena().Allocate<SymbolTable>()) SymbolTable{}},
+      log_begin_{std::size(table_->log)} {}
+
+void Scope::Insert(Bindings &bindings, Symbol name, IdentifierExpr *ident) {
+  auto &stack{bindings[name]};
+
+  // 同一作用域中的重复声明替换之前的声明
+  if (!std::empty(stack) && stack.back().scope == this) {
+    stack.back().ident = ident;
+  } else {
+    stack.push_back({this, ident});
+    table_->log.push_back(&stack);
+  }
+}
+
+IdentifierExpr *Scope::Find(Bindings &bindings, Symbol name) {
+  auto iter{bindings.find(name)};
+  if (iter == std::end(bindings) || std::empty(iter->second)) {
+    return nullptr;
+  } else {
+    return iter->second.back().ident;
+  }
+}
+
+IdentifierExpr *Scope::FindInCurrScope(Bindings &bindings, Symbol name) {
+  auto iter{bindings.find(name)};
+  if (iter == std::end(bindings) || std::empty(iter->second) ||
+      iter->second.back().scope != this) {
+    return nullptr;
+  } else {
+    return iter->second.back().ident;
+  }
+}
 
 }  // namespace kcc
@@ -0,0 +1,491 @@
+//
+// Created by kaiser on 2026/10/16.
+//
+
+#include "server.h"
+
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <llvm/Support/CommandLine.h>
+
+#include "encoding.h"
+#include "error.h"
+#include "header_cache.h"
+#include "util.h"
+
+namespace kcc {
+
+namespace {
+
+// 协议:
+// 客户端发送 4 字节的负载长度, 并通过 SCM_RIGHTS 附带标准输入, 输出, 错误
+// 负载为以 '\0' 分隔的工作目录及命令行参数
+// 服务器回复 4 字节的退出码
+constexpr std::size_t FdCount{3};
+
+// 默认的套接字放在只有当前用户可以访问的目录中, 防止其他用户抢先绑定
+// 同一路径, 截获客户端的命令行和标准输入输出
+// 目录不存在且 create 为 true 时创建它, 不安全时返回空字符串
+std::string GetSocketDirectory(bool create) {
+  if (auto dir{std::getenv("XDG_RUNTIME_DIR")};
+      dir != nullptr && *dir != '\0') {
+    return dir;
+  }
+
+  auto dir{"/tmp/kcc-" + std::to_string(getuid())};
+  if (create && mkdir(dir.c_str(), 0700) == -1 && errno != EEXIST) {
+    Error("can not create directory '{}': {}", dir, std::strerror(errno));
+  }
+
+  struct stat st {};
+  if (lstat(dir.c_str(), &st) == -1 || !S_ISDIR(st.st_mode) ||
+      st.st_uid != getuid() || (st.st_mode & 077) != 0) {
+    return {};
+  }
+  return dir;
+}
+
+// KCC_SERVER_SOCKET 指定套接字的路径, 否则使用上面目录中的 kcc.sock
+std::string GetSocketPath(bool create) {
+  if (auto path{std::getenv("KCC_SERVER_SOCKET")};
+      path != nullptr && *path != '\0') {
+    return path;
+  }
+
+  if (auto dir{GetSocketDirectory(create)}; !std::empty(dir)) {
+    return dir + "/kcc.sock";
+  }
+  return {};
+}
+
+// 对端必须与当前进程属于同一用户
+bool CheckPeer(std::int32_t fd) {
+  ucred cred{};
+  socklen_t size{sizeof(cred)};
+  if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &size) == -1) {
+    return false;
+  }
+  return cred.uid == getuid();
+}
+
+sockaddr_un GetSocketAddress(const std::string &path) {
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  if (std::size(path) >= sizeof(addr.sun_path)) {
+    Error("socket path too long: '{}'", path);
+  }
+  std::strcpy(addr.sun_path, path.c_str());
+  return addr;
+}
+
+bool WriteAll(std::int32_t fd, const void *data, std::size_t size) {
+  auto p{static_cast<const char *>(data)};
+  while (size > 0) {
+    auto n{write(fd, p, size)};
+    if (n == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    p += n;
+    size -= static_cast<std::size_t>(n);
+  }
+  return true;
+}
+
+bool ReadAll(std::int32_t fd, void *data, std::size_t size) {
+  auto p{static_cast<char *>(data)};
+  while (size > 0) {
+    auto n{read(fd, p, size)};
+    if (n == -1 && errno == EINTR) {
+      continue;
+    } else if (n <= 0) {
+      return false;
+    }
+    p += n;
+    size -= static_cast<std::size_t>(n);
+  }
+  return true;
+}
+
+bool SendRequest(std::int32_t fd, const std::string &payload) {
+  auto size{static_cast<std::uint32_t>(std::size(payload))};
+
+  iovec iov{&size, sizeof(size)};
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(std::int32_t) * FdCount)]{};
+
+  msghdr msg{};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+
+  auto cmsg{CMSG_FIRSTHDR(&msg)};
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(std::int32_t) * FdCount);
+  std::int32_t fds[FdCount]{STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO};
+  std::memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+
+  while (sendmsg(fd, &msg, 0) == -1) {
+    if (errno != EINTR) {
+      return false;
+    }
+  }
+
+  return WriteAll(fd, payload.data(), std::size(payload));
+}
+
+bool ReceiveRequest(std::int32_t fd, std::vector<std::int32_t> &fds,
+                    std::string &payload) {
+  std::uint32_t size{};
+
+  iovec iov{&size, sizeof(size)};
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(std::int32_t) * FdCount)]{};
+
+  msghdr msg{};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+
+  ssize_t n;
+  while ((n = recvmsg(fd, &msg, MSG_WAITALL)) == -1 && errno == EINTR) {
+  }
+  if (n != sizeof(size)) {
+    return false;
+  }
+
+  for (auto cmsg{CMSG_FIRSTHDR(&msg)}; cmsg != nullptr;
+       cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+    if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+      auto count{(cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(std::int32_t)};
+      fds.resize(count);
+      std::memcpy(fds.data(), CMSG_DATA(cmsg), sizeof(std::int32_t) * count);
+    }
+  }
+  if (std::size(fds) != FdCount) {
+    return false;
+  }
+
+  payload.resize(size);
+  return ReadAll(fd, payload.data(), size);
+}
+
+// 数据报的最大长度, 远小于套接字的发送缓冲区
+constexpr std::size_t ReportSize{32 * 1024};
+
+// 子进程编译结束后把自己读取过的头文件 (不包括从服务器继承的) 报告给服务器,
+// 服务器预先读入它们, 之后的请求从 fork 时继承的缓存中直接得到头文件内容
+// 每个头文件为以 '\0' 结尾的文件名, 大小, 修改时间, guard, 按 ReportSize
+// 分成多个数据报, 每个数据报中只有完整的头文件
+void ReportHeaders(std::int32_t report) {
+  std::string datagram;
+  auto flush{[&] {
+    // 只是优化, 服务器繁忙时放弃
+    if (!std::empty(datagram)) {
+      send(report, datagram.data(), std::size(datagram), MSG_DONTWAIT);
+      datagram.clear();
+    }
+  }};
+
+  for (const auto &item : GetCachedHeaders()) {
+    std::string record{item.name};
+    record.push_back('\0');
+    record += std::to_string(item.size);
+    record.push_back('\0');
+    record += std::to_string(item.mtime);
+    record.push_back('\0');
+    record += item.guard;
+    record.push_back('\0');
+
+    if (std::size(record) > ReportSize) {
+      continue;
+    }
+    if (std::size(datagram) + std::size(record) > ReportSize) {
+      flush();
+    }
+    datagram += record;
+  }
+
+  flush();
+}
+
+void PreloadDatagram(std::string_view datagram) {
+  std::vector<std::string_view> fields;
+  for (auto rest{datagram}; !std::empty(rest);) {
+    auto end{rest.find('\0')};
+    if (end == std::string_view::npos) {
+      return;
+    }
+    fields.push_back(rest.substr(0, end));
+    rest.remove_prefix(end + 1);
+  }
+
+  for (std::size_t i{}; i + 4 <= std::size(fields); i += 4) {
+    CachedHeader header{std::string{fields[i]}, {}, {},
+                        std::string{fields[i + 3]}};
+    auto size{fields[i + 1]};
+    auto mtime{fields[i + 2]};
+    if (std::from_chars(size.data(), size.data() + std::size(size),
+                        header.size)
+                .ec != std::errc{} ||
+        std::from_chars(mtime.data(), mtime.data() + std::size(mtime),
+                        header.mtime)
+                .ec != std::errc{}) {
+      return;
+    }
+    PreloadHeader(header);
+  }
+}
+
+// 读完所有已经到达的数据报, 之后接受的请求就能继承这些头文件
+void PreloadHeaders(std::int32_t report) {
+  static std::vector<char> buffer(ReportSize);
+
+  ssize_t n;
+  while ((n = recv(report, buffer.data(), std::size(buffer), MSG_DONTWAIT)) >
+         0) {
+    PreloadDatagram({buffer.data(), static_cast<std::size_t>(n)});
+  }
+}
+
+[[noreturn]] void Compile(std::int32_t (*run)(),
+                          const std::vector<std::int32_t> &fds,
+                          const std::string &payload, std::int32_t report) {
+  for (std::size_t i{}; i < FdCount; ++i) {
+    dup2(fds[i], static_cast<std::int32_t>(i));
+    close(fds[i]);
+  }
+
+  std::vector<char *> args;
+  for (std::size_t begin{}; begin < std::size(payload);) {
+    auto end{payload.find('\0', begin)};
+    args.push_back(const_cast<char *>(payload.data()) + begin);
+    begin = end + 1;
+  }
+  if (std::size(args) < 2) {
+    Error("bad request");
+  }
+
+  // 第一个字符串为客户端的工作目录
+  if (chdir(args.front()) == -1) {
+    Error("can not change directory to '{}'", args.front());
+  }
+  args.erase(std::begin(args));
+
+  try {
+    llvm::cl::ResetAllOptionOccurrences();
+    InitCommandLine(static_cast<int>(std::size(args)), args.data());
+    auto status{run()};
+    std::fflush(nullptr);
+    ReportHeaders(report);
+    std::_Exit(status);
+  } catch (const std::exception &error) {
+    Error("{}", error.what());
+  }
+}
+
+// 处理一个连接, 在 fork 出的子进程中运行
+[[noreturn]] void HandleConnection(std::int32_t (*run)(), std::int32_t fd,
+                                   std::int32_t report) {
+  signal(SIGCHLD, SIG_DFL);
+
+  std::vector<std::int32_t> fds;
+  std::string payload;
+  if (!ReceiveRequest(fd, fds, payload)) {
+    std::_Exit(EXIT_FAILURE);
+  }
+
+  auto pid{fork()};
+  if (pid == -1) {
+    std::_Exit(EXIT_FAILURE);
+  } else if (pid == 0) {
+    close(fd);
+    Compile(run, fds, payload, report);
+  }
+
+  for (auto item : fds) {
+    close(item);
+  }
+
+  std::int32_t status;
+  while (waitpid(pid, &status, 0) == -1 && errno == EINTR) {
+  }
+
+  std::int32_t result{EXIT_FAILURE};
+  if (WIFEXITED(status)) {
+    result = WEXITSTATUS(status);
+  }
+  WriteAll(fd, &result, sizeof(result));
+  std::_Exit(EXIT_SUCCESS);
+}
+
+}  // namespace
+
+std::optional<std::int32_t> RunClient(int argc, char *argv[]) {
+  if (auto enable{std::getenv("KCC_SERVER")};
+      enable == nullptr || *enable == '\0' || std::strcmp(enable, "0") == 0) {
+    return {};
+  }
+
+  for (auto i{1}; i < argc; ++i) {
+    if (std::strcmp(argv[i], "-server") == 0 ||
+        std::strcmp(argv[i], "--server") == 0) {
+      return {};
+    }
+  }
+
+  auto path{GetSocketPath(false)};
+  if (std::empty(path)) {
+    return {};
+  }
+
+  auto addr{GetSocketAddress(path)};
+  auto fd{socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)};
+  if (fd == -1) {
+    return {};
+  }
+
+  // 服务器没有运行时退回到本地编译
+  if (connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == -1) {
+    close(fd);
+    return {};
+  }
+
+  if (!CheckPeer(fd)) {
+    Warning("'{}' is not owned by the current user, ignore it", path);
+    PrintWarnings();
+    close(fd);
+    return {};
+  }
+
+  std::error_code error_code;
+  auto cwd{std::filesystem::current_path(error_code)};
+  if (error_code) {
+    close(fd);
+    return {};
+  }
+
+  std::string payload{cwd.string()};
+  payload.push_back('\0');
+  for (auto i{0}; i < argc; ++i) {
+    payload += argv[i];
+    payload.push_back('\0');
+  }
+
+  if (!SendRequest(fd, payload)) {
+    close(fd);
+    return {};
+  }
+
+  // 请求已经发出, 此后的失败不能再退回到本地编译, 否则可能编译两次
+  std::int32_t status;
+  if (!ReadAll(fd, &status, sizeof(status))) {
+    Error("lost connection to the compile server");
+  }
+
+  close(fd);
+  return status;
+}
+
+void RunServer(std::int32_t (*run)()) {
+  auto path{GetSocketPath(true)};
+  if (std::empty(path)) {
+    Error("the socket directory is not private to the current user");
+  }
+  auto addr{GetSocketAddress(path)};
+
+  auto fd{socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)};
+  if (fd == -1) {
+    Error("can not create socket: {}", std::strerror(errno));
+  }
+
+  // 套接字只允许当前用户连接
+  unlink(path.c_str());
+  auto mask{umask(077)};
+  if (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == -1) {
+    Error("can not bind '{}': {}", path, std::strerror(errno));
+  }
+  umask(mask);
+  if (listen(fd, SOMAXCONN) == -1) {
+    Error("can not listen on '{}': {}", path, std::strerror(errno));
+  }
+
+  // 由内核回收子进程
+  signal(SIGCHLD, SIG_IGN);
+
+  // 预先加载 ICU 的转换器, 之后 fork 出的子进程可以直接使用
+  std::string warm_up{"kcc"};
+  ConvertToUtf16(warm_up);
+
+  // reports[0] 由服务器读取, reports[1] 由编译的子进程写入
+  std::int32_t reports[2];
+  if (socketpair(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0, reports) == -1) {
+    Error("can not create socket: {}", std::strerror(errno));
+  }
+
+  while (true) {
+    pollfd fds[]{{fd, POLLIN, 0}, {reports[0], POLLIN, 0}};
+    if (poll(fds, std::size(fds), -1) == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      Error("poll failed: {}", std::strerror(errno));
+    }
+
+    if (fds[1].revents & POLLIN) {
+      PreloadHeaders(reports[0]);
+    }
+    if (!(fds[0].revents & POLLIN)) {
+      continue;
+    }
+
+    auto conn{accept4(fd, nullptr, nullptr, SOCK_CLOEXEC)};
+    if (conn == -1) {
+      if (errno == EINTR || errno == ECONNABORTED) {
+        continue;
+      }
+      Error("accept failed: {}", std::strerror(errno));
+    }
+
+    if (!CheckPeer(conn)) {
+      Warning("reject a connection from another user");
+      PrintWarnings();
+      close(conn);
+      continue;
+    }
+
+    if (auto pid{fork()}; pid == 0) {
+      close(fd);
+      close(reports[0]);
+      HandleConnection(run, conn, reports[1]);
+    } else if (pid == -1) {
+      Warning("fork failed: {}", std::strerror(errno));
+      PrintWarnings();
+    }
+
+    close(conn);
+  }
+}
+
+}  // namespace kcc
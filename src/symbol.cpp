@@ -0,0 +1,49 @@
+//
+// Created by kaiser on 2026/10/16.
+//
+
+#include "symbol.h"
+
+#include "context.h"
+
+namespace kcc {
+
+namespace {
+
+const std::string EmptyName;
+
+}  // namespace
+
+Symbol::Symbol(std::string_view name) {
+  if (std::empty(name)) {
+    return;
+  }
+
+  // 驻留表属于编译上下文, 只由编译该翻译单元的线程访问, 不需要加锁
+  auto &context{GetContext()};
+  if (auto iter{context.symbols.find(name)};
+      iter != std::end(context.symbols)) {
+    name_ = iter->second;
+  } else {
+    name_ = &context.names.emplace_back(name);
+    context.symbols.emplace(*name_, name_);
+  }
+}
+
+const std::string &Symbol::GetName() const {
+  return name_ == nullptr ? EmptyName : *name_;
+}
+
+bool Symbol::Empty() const { return name_ == nullptr; }
+
+void *Symbol::GetOpaqueValue() const {
+  return const_cast<std::string *>(name_);
+}
+
+Symbol Symbol::GetFromOpaqueValue(void *value) {
+  Symbol symbol;
+  symbol.name_ = static_cast<const std::string *>(value);
+  return symbol;
+}
+
+}  // namespace kcc
@@ -9,8 +9,6 @@
 #include <fmt/format.h>
 #include <magic_enum.hpp>
 
-#include "lex.h"
-
 namespace kcc {
 
 /*
@@ -22,13 +20,32 @@ void Token::SetTag(Tag tag) { tag_ = tag; }
 
 Tag Token::GetTag() const { return tag_; }
 
-std::string Token::GetStr() const { return str_; }
+std::string_view Token::GetStr() const {
+  if (IsIdentifier()) {
+    return GetSymbol().GetName();
+  } else {
+    return {static_cast<const char *>(data_), size_};
+  }
+}
+
+void Token::SetStr(std::string_view str) {
+  assert(std::size(str) <= MaxSize);
+  data_ = str.data();
+  size_ = std::size(str);
+}
+
+std::string_view Token::GetSpelling() const {
+  return {static_cast<const char *>(data_), size_};
+}
 
-void Token::SetStr(const std::string &str) { str_ = str; }
+Symbol Token::GetSymbol() const {
+  assert(IsIdentifier());
+  return Symbol::GetFromOpaqueValue(const_cast<void *>(data_));
+}
 
-std::string Token::GetIdentifier() const {
+void Token::SetSymbol(Symbol symbol) {
   assert(IsIdentifier());
-  return Scanner{str_}.HandleIdentifier();
+  data_ = symbol.GetOpaqueValue();
 }
 
 Location Token::GetLoc() const { return loc_; }
@@ -37,7 +54,7 @@ void Token::SetLoc(const Location &loc) { loc_ = loc; }
 
 std::string Token::ToString() const {
   return fmt::format("{:<25}str: {:<25}loc: <{}>", magic_enum::enum_name(tag_),
-                     str_, loc_.ToLocStr());
+                     GetStr(), loc_.ToLocStr());
 }
 
 bool Token::IsEof() const { return tag_ == Tag::kEof; }
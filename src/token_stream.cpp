@@ -0,0 +1,101 @@
+//
+// Created by kaiser on 2026/10/16.
+//
+
+#include "token_stream.h"
+
+#include <cassert>
+
+#include "symbol.h"
+
+namespace kcc {
+
+TokenStream::TokenStream(std::string_view code, const Location &loc)
+    : scanner_{code, loc}, rescanner_{code, loc} {
+  scanner_.Detach();
+  thread_ = std::thread{[this] { Run(); }};
+}
+
+TokenStream::~TokenStream() {
+  // 词法分析线程可能在等待缓冲区中的空位, 读完剩下的记号
+  while (!eof_) {
+    for (auto tail{Acquire()}; read_ != tail; ++read_) {
+      eof_ = buffer_[read_ % Capacity].IsEof();
+    }
+    Release();
+  }
+
+  thread_.join();
+}
+
+void TokenStream::Read(std::vector<Token> &tokens) {
+  assert(!eof_);
+
+  for (auto tail{Acquire()}; read_ != tail; ++read_) {
+    auto token{buffer_[read_ % Capacity]};
+    // 词法分析线程最后写入的总是 kEof
+    eof_ = token.IsEof();
+
+    if (token.TagIs(Tag::kNone)) {
+      token = rescanner_.Rescan(token.GetLoc());
+    } else if (token.IsIdentifier()) {
+      token.SetSymbol(Symbol{token.GetSpelling()});
+    }
+
+    tokens.push_back(token);
+  }
+
+  Release();
+}
+
+void TokenStream::Run() {
+  while (true) {
+    const auto &token{scanner_.ScanDetached()};
+    Write(token);
+
+    if (token.IsEof()) {
+      break;
+    }
+  }
+
+  Publish();
+}
+
+void TokenStream::Write(const Token &token) {
+  if (write_ - head_cache_ == Capacity) {
+    // 缓冲区已满, 先让语法分析线程看到所有的记号再等待
+    Publish();
+    while (write_ - (head_cache_ = head_.load(std::memory_order_acquire)) ==
+           Capacity) {
+      head_.wait(head_cache_, std::memory_order_acquire);
+    }
+  }
+
+  buffer_[write_ % Capacity] = token;
+
+  if (++write_ % BatchSize == 0) {
+    Publish();
+  }
+}
+
+void TokenStream::Publish() {
+  tail_.store(write_, std::memory_order_release);
+  tail_.notify_one();
+}
+
+std::uint32_t TokenStream::Acquire() {
+  auto tail{tail_.load(std::memory_order_acquire)};
+  while (tail == read_) {
+    tail_.wait(tail, std::memory_order_acquire);
+    tail = tail_.load(std::memory_order_acquire);
+  }
+
+  return tail;
+}
+
+void TokenStream::Release() {
+  head_.store(read_, std::memory_order_release);
+  head_.notify_one();
+}
+
+}  // namespace kcc
@@ -7,18 +7,26 @@
 #include <algorithm>
 #include <cassert>
 #include <limits>
+#include <unordered_map>
 
+#include <llvm/ADT/Hashing.h>
 #include <llvm/IR/DerivedTypes.h>
 #include <llvm/Support/Casting.h>
 
+#include "arena.h"
 #include "ast.h"
 #include "error.h"
 #include "llvm_common.h"
-#include "memory_pool.h"
-#include "scope.h"
 
 namespace kcc {
 
+/*
+ * DerivedTypeKeyHash
+ */
+std::size_t DerivedTypeKeyHash::operator()(const DerivedTypeKey &key) const {
+  return llvm::hash_combine(key.type, key.type_qual, key.num_elements);
+}
+
 /*
  * QualType
  */
@@ -106,44 +114,44 @@ llvm::Type *Type::GetLLVMType() const {
   return llvm_type_;
 }
 
-VoidType *Type::ToVoidType() { return dynamic_cast<VoidType *>(this); }
+VoidType *Type::ToVoidType() { return llvm::dyn_cast<VoidType>(this); }
 
 ArithmeticType *Type::ToArithmeticType() {
-  return dynamic_cast<ArithmeticType *>(this);
+  return llvm::dyn_cast<ArithmeticType>(this);
 }
 
-PointerType *Type::ToPointerType() { return dynamic_cast<PointerType *>(this); }
+PointerType *Type::ToPointerType() { return llvm::dyn_cast<PointerType>(this); }
 
-ArrayType *Type::ToArrayType() { return dynamic_cast<ArrayType *>(this); }
+ArrayType *Type::ToArrayType() { return llvm::dyn_cast<ArrayType>(this); }
 
-StructType *Type::ToStructType() { return dynamic_cast<StructType *>(this); }
+StructType *Type::ToStructType() { return llvm::dyn_cast<StructType>(this); }
 
 FunctionType *Type::ToFunctionType() {
-  return dynamic_cast<FunctionType *>(this);
+  return llvm::dyn_cast<FunctionType>(this);
 }
 
 const VoidType *Type::ToVoidType() const {
-  return dynamic_cast<const VoidType *>(this);
+  return llvm::dyn_cast<VoidType>(this);
 }
 
 const ArithmeticType *Type::ToArithmeticType() const {
-  return dynamic_cast<const ArithmeticType *>(this);
+  return llvm::dyn_cast<ArithmeticType>(this);
 }
 
 const PointerType *Type::ToPointerType() const {
-  return dynamic_cast<const PointerType *>(this);
+  return llvm::dyn_cast<PointerType>(this);
 }
 
 const ArrayType *Type::ToArrayType() const {
-  return dynamic_cast<const ArrayType *>(this);
+  return llvm::dyn_cast<ArrayType>(this);
 }
 
 const StructType *Type::ToStructType() const {
-  return dynamic_cast<const StructType *>(this);
+  return llvm::dyn_cast<StructType>(this);
 }
 
 const FunctionType *Type::ToFunctionType() const {
-  return dynamic_cast<const FunctionType *>(this);
+  return llvm::dyn_cast<FunctionType>(this);
 }
 
 bool Type::IsComplete() const { return complete_; }
@@ -156,259 +164,245 @@ void Type::SetComplete(bool complete) {
   }
 }
 
-bool Type::IsUnsigned() const {
-  if (IsBoolTy()) {
-    return true;
-  }
+bool Type::IsUnsigned() const { return Is(kUnsignedTy); }
 
-  if (!IsIntegerTy()) {
-    return false;
-  } else {
-    return ToArithmeticType()->type_spec_ & kUnsigned;
-  }
-}
-
-bool Type::IsVoidTy() const { return ToVoidType(); }
+bool Type::IsVoidTy() const { return Is(kVoidTy); }
 
-bool Type::IsBoolTy() const {
-  auto type{ToArithmeticType()};
-  return type && (type->type_spec_ == kBool);
-}
+bool Type::IsBoolTy() const { return Is(kBoolTy); }
 
 bool Type::IsShortTy() const {
-  auto type{ToArithmeticType()};
+  auto type{llvm::dyn_cast<ArithmeticType>(this)};
   return type && ((type->type_spec_ == kShort) ||
                   (type->type_spec_ == (kShort | kUnsigned)));
 }
 
 bool Type::IsIntTy() const {
-  auto type{ToArithmeticType()};
+  auto type{llvm::dyn_cast<ArithmeticType>(this)};
   return type && ((type->type_spec_ == kInt) ||
                   (type->type_spec_ == (kInt | kUnsigned)));
 }
 
 bool Type::IsLongTy() const {
-  auto type{ToArithmeticType()};
+  auto type{llvm::dyn_cast<ArithmeticType>(this)};
   return type && ((type->type_spec_ == kLong) ||
                   (type->type_spec_ == (kLong | kUnsigned)));
 }
 
 bool Type::IsLongLongTy() const {
-  auto type{ToArithmeticType()};
+  auto type{llvm::dyn_cast<ArithmeticType>(this)};
   return type && ((type->type_spec_ == kLongLong) ||
                   (type->type_spec_ == (kLongLong | kUnsigned)));
 }
 
 bool Type::IsFloatTy() const {
-  auto type{ToArithmeticType()};
+  auto type{llvm::dyn_cast<ArithmeticType>(this)};
   return type && (type->type_spec_ == kFloat);
 }
 
 bool Type::IsDoubleTy() const {
-  auto type{ToArithmeticType()};
+  auto type{llvm::dyn_cast<ArithmeticType>(this)};
   return type && (type->type_spec_ == kDouble);
 }
 
 bool Type::IsLongDoubleTy() const {
-  auto type{ToArithmeticType()};
+  auto type{llvm::dyn_cast<ArithmeticType>(this)};
   return type && (type->type_spec_ == (kLong | kDouble));
 }
 
-bool Type::IsPointerTy() const { return ToPointerType(); }
+bool Type::IsPointerTy() const { return Is(kPointerTy); }
 
-bool Type::IsArrayTy() const { return ToArrayType(); }
+bool Type::IsArrayTy() const { return Is(kArrayTy); }
 
-bool Type::IsStructTy() const {
-  auto type{ToStructType()};
-  return type && type->is_struct_;
-}
+bool Type::IsStructTy() const { return Is(kStructTy); }
 
-bool Type::IsUnionTy() const {
-  auto type{ToStructType()};
-  return type && !type->is_struct_;
-}
+bool Type::IsUnionTy() const { return Is(kUnionTy); }
 
-bool Type::IsStructOrUnionTy() const { return IsStructTy() || IsUnionTy(); }
+bool Type::IsStructOrUnionTy() const { return Is(kStructTy | kUnionTy); }
 
-bool Type::IsFunctionTy() const { return ToFunctionType(); }
+bool Type::IsFunctionTy() const { return Is(kFunctionTy); }
 
-bool Type::IsCharacterTy() const {
-  auto type{ToArithmeticType()};
-  return type && (type->type_spec_ & kChar);
-}
+bool Type::IsCharacterTy() const { return Is(kCharacterTy); }
 
-bool Type::IsIntegerTy() const {
-  return ToArithmeticType() && !IsFloatPointTy() && !IsBoolTy();
-}
+bool Type::IsIntegerTy() const { return Is(kIntegerTy); }
 
-bool Type::IsRealTy() const { return IsIntegerTy() || IsRealFloatPointTy(); }
+bool Type::IsRealTy() const { return Is(kIntegerTy | kRealFloatPointTy); }
 
-bool Type::IsArithmeticTy() const {
-  return IsBoolTy() || IsIntegerTy() || IsFloatPointTy();
-}
+bool Type::IsArithmeticTy() const { return Is(kArithmeticTy); }
 
-bool Type::IsScalarTy() const { return IsArithmeticTy() || IsPointerTy(); }
+bool Type::IsScalarTy() const { return Is(kScalarTy); }
 
-bool Type::IsAggregateTy() const { return IsArrayTy() || IsStructOrUnionTy(); }
+bool Type::IsAggregateTy() const { return Is(kAggregateTy); }
 
-bool Type::IsRealFloatPointTy() const {
-  return IsFloatTy() || IsDoubleTy() || IsLongDoubleTy();
-}
+bool Type::IsRealFloatPointTy() const { return Is(kRealFloatPointTy); }
 
 bool Type::IsFloatPointTy() const {
   // 不支持虚浮点数
   return IsRealFloatPointTy();
 }
 
-bool Type::IsIntegerOrBoolTy() const { return IsIntegerTy() || IsBoolTy(); }
+bool Type::IsIntegerOrBoolTy() const { return Is(kIntegerTy | kBoolTy); }
 
 PointerType *Type::GetPointerTo() { return PointerType::Get(this); }
 
 std::int32_t Type::ArithmeticRank() const {
   assert(IsArithmeticTy());
-  return ToArithmeticType()->Rank();
+  return llvm::cast<ArithmeticType>(this)->Rank();
 }
 
 std::uint64_t Type::ArithmeticMaxIntegerValue() const {
   assert(IsArithmeticTy());
-  return ToArithmeticType()->MaxIntegerValue();
+  return llvm::cast<ArithmeticType>(this)->MaxIntegerValue();
 }
 
 QualType Type::PointerGetElementType() const {
   assert(IsPointerTy());
-  return ToPointerType()->GetElementType();
+  return llvm::cast<PointerType>(this)->GetElementType();
 }
 
 void Type::ArraySetNumElements(std::size_t num_elements) {
   assert(IsArrayTy());
-  ToArrayType()->SetNumElements(num_elements);
+  llvm::cast<ArrayType>(this)->SetNumElements(num_elements);
 }
 
 std::size_t Type::ArrayGetNumElements() const {
   assert(IsArrayTy());
-  return ToArrayType()->GetNumElements();
+  return llvm::cast<ArrayType>(this)->GetNumElements();
 }
 
 QualType Type::ArrayGetElementType() const {
   assert(IsArrayTy());
-  return ToArrayType()->GetElementType();
+  return llvm::cast<ArrayType>(this)->GetElementType();
 }
 
 bool Type::StructHasName() const {
   assert(IsStructOrUnionTy());
-  return ToStructType()->HasName();
+  return llvm::cast<StructType>(this)->HasName();
 }
 
 void Type::StructSetName(const std::string &name) {
   assert(IsStructOrUnionTy());
-  ToStructType()->SetName(name);
+  llvm::cast<StructType>(this)->SetName(name);
 }
 
 const std::string &Type::StructGetName() const {
   assert(IsStructOrUnionTy());
-  return ToStructType()->GetName();
+  return llvm::cast<StructType>(this)->GetName();
 }
 
 std::vector<ObjectExpr *> &Type::StructGetMembers() {
   assert(IsStructOrUnionTy());
-  return ToStructType()->GetMembers();
+  return llvm::cast<StructType>(this)->GetMembers();
 }
 
-const std::vector<ObjectExpr *> &Type::FuncGetParams() const {
+const std::vector<ObjectExpr *> &Type::StructGetMembers() const {
   assert(IsStructOrUnionTy());
-  return ToStructType()->GetMembers();
+  return llvm::cast<StructType>(this)->GetMembers();
 }
 
 void Type::StructSetMembers(std::vector<ObjectExpr *> &members) {
   assert(IsStructOrUnionTy());
-  ToStructType()->SetMembers(members);
+  llvm::cast<StructType>(this)->SetMembers(members);
 }
 
-ObjectExpr *Type::StructGetMember(const std::string &name) const {
+ObjectExpr *Type::StructGetMember(Symbol name) const {
   assert(IsStructOrUnionTy());
-  return ToStructType()->GetMember(name);
+  return llvm::cast<StructType>(this)->GetMember(name);
 }
 
 QualType Type::StructGetMemberType(std::int32_t i) const {
   assert(IsStructOrUnionTy());
-  return ToStructType()->GetMemberType(i);
+  return llvm::cast<StructType>(this)->GetMemberType(i);
 }
 
-Scope *Type::StructGetScope() {
+const std::unordered_map<Symbol, ObjectExpr *> &Type::StructGetMemberMap()
+    const {
   assert(IsStructOrUnionTy());
-  return ToStructType()->GetScope();
+  return llvm::cast<StructType>(this)->GetMemberMap();
 }
 
 void Type::StructAddMember(ObjectExpr *member) {
   assert(IsStructOrUnionTy());
-  ToStructType()->AddMember(member);
+  llvm::cast<StructType>(this)->AddMember(member);
 }
 
 void Type::StructMergeAnonymous(ObjectExpr *anonymous) {
   assert(IsStructOrUnionTy());
-  ToStructType()->MergeAnonymous(anonymous);
+  llvm::cast<StructType>(this)->MergeAnonymous(anonymous);
 }
 
 std::int32_t Type::StructGetOffset() const {
   assert(IsStructOrUnionTy());
-  return ToStructType()->GetOffset();
+  return llvm::cast<StructType>(this)->GetOffset();
 }
 
 void Type::StructFinish() {
   assert(IsStructOrUnionTy());
-  ToStructType()->Finish();
+  llvm::cast<StructType>(this)->Finish();
 }
 
 bool Type::FuncIsVarArgs() const {
   assert(IsFunctionTy());
-  return ToFunctionType()->IsVarArgs();
+  return llvm::cast<FunctionType>(this)->IsVarArgs();
 }
 
 QualType Type::FuncGetReturnType() const {
   assert(IsFunctionTy());
-  return ToFunctionType()->GetReturnType();
+  return llvm::cast<FunctionType>(this)->GetReturnType();
 }
 
 std::vector<ObjectExpr *> &Type::FuncGetParams() {
   assert(IsFunctionTy());
-  return ToFunctionType()->GetParams();
+  return llvm::cast<FunctionType>(this)->GetParams();
 }
 
-const std::vector<ObjectExpr *> &Type::StructGetMembers() const {
+const std::vector<ObjectExpr *> &Type::FuncGetParams() const {
   assert(IsFunctionTy());
-  return ToFunctionType()->GetParams();
+  return llvm::cast<FunctionType>(this)->GetParams();
 }
 
 void Type::FuncSetFuncSpec(std::uint32_t func_spec) {
   assert(IsFunctionTy());
-  return ToFunctionType()->SetFuncSpec(func_spec);
+  return llvm::cast<FunctionType>(this)->SetFuncSpec(func_spec);
 }
 
 bool Type::FuncIsInline() const {
   assert(IsFunctionTy());
-  return ToFunctionType()->IsInline();
+  return llvm::cast<FunctionType>(this)->IsInline();
 }
 
 void Type::FuncSetName(const std::string &name) {
   assert(IsFunctionTy());
-  ToFunctionType()->SetName(name);
+  llvm::cast<FunctionType>(this)->SetName(name);
 }
 
 const std::string &Type::FuncGetName() const {
   assert(IsFunctionTy());
-  return ToFunctionType()->GetName();
+  return llvm::cast<FunctionType>(this)->GetName();
 }
 
-Type::Type(bool complete) : complete_{complete} {}
+TypeKind Type::GetKind() const { return kind_; }
+
+Type::Type(TypeKind kind, std::uint16_t category, bool complete)
+    : kind_{kind}, category_{category}, complete_{complete} {}
+
+bool Type::Is(std::uint16_t category) const { return category_ & category; }
 
 /*
  * VoidType
  */
 VoidType *VoidType::Get() {
-  static auto type{new (VoidTypePool.malloc()) VoidType{}};
+  auto &type{GetContext().types.void_type};
+  if (type == nullptr) {
+    type = new (AstArena().Allocate<VoidType>()) VoidType{};
+  }
+
   return type;
 }
 
+bool VoidType::classof(const Type *type) {
+  return type->GetKind() == TypeKind::kVoid;
+}
+
 std::int32_t VoidType::GetWidth() const {
   // GNU 扩展
   return 1;
@@ -420,82 +414,38 @@ bool VoidType::Compatible(const Type *other) const { return Equal(other); }
 
 bool VoidType::Equal(const Type *other) const { return other->IsVoidTy(); }
 
-VoidType::VoidType() : Type{false} { llvm_type_ = Builder.getVoidTy(); }
+VoidType::VoidType() : Type{TypeKind::kVoid, kVoidTy, false} {
+  llvm_type_ = Builder().getVoidTy();
+}
 
 /*
  * ArithmeticType
  */
 ArithmeticType *ArithmeticType::Get(std::uint32_t type_spec) {
-  static auto bool_type{new (ArithmeticTypePool.malloc())
-                            ArithmeticType{kBool}};
-  static auto char_type{new (ArithmeticTypePool.malloc())
-                            ArithmeticType{kChar}};
-  static auto uchar_type{new (ArithmeticTypePool.malloc())
-                             ArithmeticType{kChar | kUnsigned}};
-  static auto short_type{new (ArithmeticTypePool.malloc())
-                             ArithmeticType{kShort}};
-  static auto ushort_type{new (ArithmeticTypePool.malloc())
-                              ArithmeticType{kShort | kUnsigned}};
-  static auto int_type{new (ArithmeticTypePool.malloc()) ArithmeticType{kInt}};
-  static auto uint_type{new (ArithmeticTypePool.malloc())
-                            ArithmeticType{kInt | kUnsigned}};
-  static auto long_type{new (ArithmeticTypePool.malloc())
-                            ArithmeticType{kLong}};
-  static auto ulong_type{new (ArithmeticTypePool.malloc())
-                             ArithmeticType{kLong | kUnsigned}};
-  static auto long_long_type{new (ArithmeticTypePool.malloc())
-                                 ArithmeticType{kLongLong}};
-  static auto ulong_long_type{new (ArithmeticTypePool.malloc())
-                                  ArithmeticType{kLongLong | kUnsigned}};
-  static auto float_type{new (ArithmeticTypePool.malloc())
-                             ArithmeticType{kFloat}};
-  static auto double_type{new (ArithmeticTypePool.malloc())
-                              ArithmeticType{kDouble}};
-  static auto long_double_type{new (ArithmeticTypePool.malloc())
-                                   ArithmeticType{kDouble | kLong}};
-
   type_spec = ArithmeticType::DealWithTypeSpec(type_spec);
 
-  switch (type_spec) {
-    case kBool:
-      return bool_type;
-    case kChar:
-      return char_type;
-    case kChar | kUnsigned:
-      return uchar_type;
-    case kShort:
-      return short_type;
-    case kShort | kUnsigned:
-      return ushort_type;
-    case kInt:
-      return int_type;
-    case kInt | kUnsigned:
-      return uint_type;
-    case kLong:
-      return long_type;
-    case kLong | kUnsigned:
-      return ulong_type;
-    case kLongLong:
-      return long_long_type;
-    case kLongLong | kUnsigned:
-      return ulong_long_type;
-    case kFloat:
-      return float_type;
-    case kDouble:
-      return double_type;
-    case kDouble | kLong:
-      return long_double_type;
-    default:
-      assert(false);
-      return nullptr;
+  const auto &specs{TypeTable::ArithmeticTypeSpecs};
+  auto iter{std::find(std::begin(specs), std::end(specs), type_spec)};
+  assert(iter != std::end(specs));
+
+  auto &type{GetContext().types.arithmetic_types[iter - std::begin(specs)]};
+  if (type == nullptr) {
+    type = new (AstArena().Allocate<ArithmeticType>())
+        ArithmeticType{type_spec};
   }
+
+  return type;
+}
+
+bool ArithmeticType::classof(const Type *type) {
+  return type->GetKind() == TypeKind::kArithmetic;
 }
 
 Type *ArithmeticType::IntegerPromote(Type *type) {
   assert(type != nullptr);
   assert(type->IsIntegerTy() || type->IsBoolTy());
 
-  static auto int_type{ArithmeticType::Get(kInt)};
+  auto int_type{ArithmeticType::Get(kInt)};
 
   if (type->ArithmeticRank() < int_type->Rank()) {
     return int_type;
@@ -613,30 +563,51 @@ std::uint64_t ArithmeticType::MaxIntegerValue() const {
   }
 }
 
-ArithmeticType::ArithmeticType(std::uint32_t type_spec) : Type{true} {
-  type_spec_ = ArithmeticType::DealWithTypeSpec(type_spec);
-
+ArithmeticType::ArithmeticType(std::uint32_t type_spec)
+    : Type{TypeKind::kArithmetic, Category(type_spec), true},
+      type_spec_{ArithmeticType::DealWithTypeSpec(type_spec)} {
   if (IsBoolTy()) {
-    llvm_type_ = Builder.getInt1Ty();
+    llvm_type_ = Builder().getInt1Ty();
   } else if (IsCharacterTy()) {
-    llvm_type_ = Builder.getInt8Ty();
+    llvm_type_ = Builder().getInt8Ty();
   } else if (IsShortTy()) {
-    llvm_type_ = Builder.getInt16Ty();
+    llvm_type_ = Builder().getInt16Ty();
   } else if (IsIntTy()) {
-    llvm_type_ = Builder.getInt32Ty();
+    llvm_type_ = Builder().getInt32Ty();
   } else if (IsLongTy() || IsLongLongTy()) {
-    llvm_type_ = Builder.getInt64Ty();
+    llvm_type_ = Builder().getInt64Ty();
   } else if (IsFloatTy()) {
-    llvm_type_ = Builder.getFloatTy();
+    llvm_type_ = Builder().getFloatTy();
   } else if (IsDoubleTy()) {
-    llvm_type_ = Builder.getDoubleTy();
+    llvm_type_ = Builder().getDoubleTy();
   } else if (IsLongDoubleTy()) {
-    llvm_type_ = llvm::Type::getX86_FP80Ty(Context);
+    llvm_type_ = llvm::Type::getX86_FP80Ty(Context());
   } else {
     assert(false);
   }
 }
 
+std::uint16_t ArithmeticType::Category(std::uint32_t type_spec) {
+  type_spec = ArithmeticType::DealWithTypeSpec(type_spec);
+
+  if (type_spec == kBool) {
+    return kBoolTy | kUnsignedTy;
+  } else if (type_spec == kFloat || type_spec == kDouble ||
+             type_spec == (kLong | kDouble)) {
+    return kRealFloatPointTy;
+  }
+
+  std::uint16_t category{kIntegerTy};
+  if (type_spec & kUnsigned) {
+    category |= kUnsignedTy;
+  }
+  if (type_spec & kChar) {
+    category |= kCharacterTy;
+  }
+
+  return category;
+}
+
 std::uint32_t ArithmeticType::DealWithTypeSpec(std::uint32_t type_spec) {
   if (type_spec == kSigned) {
     type_spec = kInt;
@@ -688,7 +659,17 @@ std::int32_t ArithmeticType::Rank() const {
  * PointerType
  */
 PointerType *PointerType::Get(QualType element_type) {
-  return new (PointerTypePool.malloc()) PointerType{element_type};
+  auto &type{GetContext().types.pointer_types[{
+      element_type.GetType(), element_type.GetTypeQual(), 0}]};
+  if (type == nullptr) {
+    type = new (AstArena().Allocate<PointerType>()) PointerType{element_type};
+  }
+
+  return type;
+}
+
+bool PointerType::classof(const Type *type) {
+  return type->GetKind() == TypeKind::kPointer;
 }
 
 std::int32_t PointerType::GetWidth() const { return 8; }
@@ -699,6 +680,10 @@ std::int32_t PointerType::GetAlign() const { return GetWidth(); }
 bool PointerType::Compatible(const Type *other) const {
   assert(other != nullptr);
 
+  if (this == other) {
+    return true;
+  }
+
   if (other->IsPointerTy()) {
     return element_type_->Compatible(
         other->ToPointerType()->element_type_.GetType());
@@ -710,6 +695,10 @@ bool PointerType::Compatible(const Type *other) const {
 bool PointerType::Equal(const Type *other) const {
   assert(other != nullptr);
 
+  if (this == other) {
+    return true;
+  }
+
   if (other->IsPointerTy()) {
     return element_type_->Equal(
         other->ToPointerType()->element_type_.GetType());
@@ -721,9 +710,10 @@ bool PointerType::Equal(const Type *other) const {
 QualType PointerType::GetElementType() const { return element_type_; }
 
 PointerType::PointerType(QualType element_type)
-    : Type{true}, element_type_{element_type} {
+    : Type{TypeKind::kPointer, kPointerTy, true},
+      element_type_{element_type} {
   if (element_type_->IsVoidTy()) {
-    llvm_type_ = Builder.getInt8PtrTy();
+    llvm_type_ = Builder().getInt8PtrTy();
   } else {
     llvm_type_ = element_type_->GetLLVMType()->getPointerTo();
   }
@@ -734,7 +724,24 @@ PointerType::PointerType(QualType element_type)
  */
 ArrayType *ArrayType::Get(QualType contained_type,
                           std::optional<std::size_t> num_elements) {
-  return new (ArrayTypePool.malloc()) ArrayType{contained_type, num_elements};
+  // 未知边界的数组在初始化时会设置元素数量, 每次都创建新的类型
+  if (!num_elements) {
+    return new (AstArena().Allocate<ArrayType>())
+        ArrayType{contained_type, num_elements};
+  }
+
+  auto &type{GetContext().types.array_types[{
+      contained_type.GetType(), contained_type.GetTypeQual(), *num_elements}]};
+  if (type == nullptr) {
+    type = new (AstArena().Allocate<ArrayType>())
+        ArrayType{contained_type, num_elements};
+  }
+
+  return type;
+}
+
+bool ArrayType::classof(const Type *type) {
+  return type->GetKind() == TypeKind::kArray;
 }
 
 std::int32_t ArrayType::GetWidth() const {
@@ -750,6 +757,10 @@ std::int32_t ArrayType::GetAlign() const { return contained_type_->GetAlign(); }
 bool ArrayType::Compatible(const Type *other) const {
   assert(other != nullptr);
 
+  if (this == other) {
+    return true;
+  }
+
   if (other->IsArrayTy()) {
     auto other_arr{other->ToArrayType()};
     if (!contained_type_->Compatible(other_arr->contained_type_.GetType())) {
@@ -768,6 +779,10 @@ bool ArrayType::Compatible(const Type *other) const {
 bool ArrayType::Equal(const Type *other) const {
   assert(other != nullptr);
 
+  if (this == other) {
+    return true;
+  }
+
   if (other->IsArrayTy()) {
     auto other_arr{other->ToArrayType()};
     if (!contained_type_->Equal(other_arr->contained_type_.GetType())) {
@@ -804,7 +819,7 @@ QualType ArrayType::GetElementType() const { return contained_type_; }
 
 ArrayType::ArrayType(QualType contained_type,
                      std::optional<std::size_t> num_elements)
-    : Type{num_elements.has_value()},
+    : Type{TypeKind::kArray, kArrayTy, num_elements.has_value()},
       contained_type_{contained_type},
       num_elements_{num_elements} {
   if (num_elements.has_value()) {
@@ -818,16 +833,22 @@ ArrayType::ArrayType(QualType contained_type,
 /*
  * StructType
  */
-StructType *StructType::Get(bool is_struct, const std::string &name,
-                            Scope *parent) {
-  return new (StructTypePool.malloc()) StructType{is_struct, name, parent};
+StructType *StructType::Get(bool is_struct, const std::string &name) {
+  return new (AstArena().Allocate<StructType>()) StructType{is_struct, name};
+}
+
+bool StructType::classof(const Type *type) {
+  return type->GetKind() == TypeKind::kStruct;
 }
 
 std::int32_t StructType::GetWidth() const {
   assert(IsComplete());
 
   auto struct_type{llvm::cast<llvm::StructType>(llvm_type_)};
-  return Module->getDataLayout().getStructLayout(struct_type)->getSizeInBytes();
+  return Module()
+      .getDataLayout()
+      .getStructLayout(struct_type)
+      ->getSizeInBytes();
 }
 
 std::int32_t StructType::GetAlign() const {
@@ -836,7 +857,7 @@ std::int32_t StructType::GetAlign() const {
   }
 
   auto struct_type{llvm::cast<llvm::StructType>(llvm_type_)};
-  return Module->getDataLayout()
+  return Module().getDataLayout()
       .getStructLayout(struct_type)
       ->getAlignment()
       .value();
@@ -920,21 +941,19 @@ void StructType::SetMembers(std::vector<ObjectExpr *> &members) {
   members_ = members;
 }
 
-ObjectExpr *StructType::GetMember(const std::string &name) const {
-  auto ident{scope_->FindUsualInCurrScope(name)};
-  if (ident == nullptr) {
-    return nullptr;
-  } else {
-    assert(ident->IsObject());
-    return ident->ToObjectExpr();
-  }
+ObjectExpr *StructType::GetMember(Symbol name) const {
+  auto iter{member_map_.find(name)};
+  return iter == std::end(member_map_) ? nullptr : iter->second;
 }
 
 QualType StructType::GetMemberType(std::int32_t i) const {
   return members_[i]->GetQualType();
 }
 
-Scope *StructType::GetScope() { return scope_; }
+const std::unordered_map<Symbol, ObjectExpr *> &StructType::GetMemberMap()
+    const {
+  return member_map_;
+}
 
 std::int32_t StructType::GetOffset() const { return offset_; }
 
@@ -957,7 +976,7 @@ void StructType::AddMember(ObjectExpr *member) {
   member->GetIndexs().push_front({this, index_++});
 
   members_.push_back(member);
-  scope_->InsertUsual(member);
+  member_map_[member->GetSymbol()] = member;
 
   AddLLVMType(type);
   if (is_struct_) {
@@ -985,19 +1004,15 @@ void StructType::MergeAnonymous(ObjectExpr *anonymous) {
 
   members_.push_back(anonymous);
 
-  for (auto &&[name, obj] : *anonymous_type->scope_) {
-    if (auto member{obj->ToObjectExpr()}; !member) {
-      continue;
-    } else {
-      if (GetMember(name)) {
-        Error(member->GetLoc(), "duplicated member: '{}'", name);
-      }
+  for (auto &&[name, member] : anonymous_type->member_map_) {
+    if (GetMember(name)) {
+      Error(member->GetLoc(), "duplicated member: '{}'", name.GetName());
+    }
 
-      member->SetOffset(offset + member->GetOffset());
+    member->SetOffset(offset + member->GetOffset());
 
-      scope_->InsertUsual(member);
-      member->GetIndexs().push_front({this, index_});
-    }
+    member_map_[name] = member;
+    member->GetIndexs().push_front({this, index_});
   }
 
   ++index_;
@@ -1061,7 +1076,7 @@ void StructType::AddBitField(ObjectExpr *member) {
     member->GetIndexs().push_front({this, index_});
 
     members_.push_back(member);
-    scope_->InsertUsual(member);
+    member_map_[member->GetSymbol()] = member;
 
     // 如果是 struct , 当打包满了或者下一个不是位域字段时再改变 offset_
     if (!is_struct_) {
@@ -1101,7 +1116,7 @@ void StructType::AddBitField(ObjectExpr *member) {
         member->GetIndexs().push_front({this, index_});
 
         members_.push_back(member);
-        scope_->InsertUsual(member);
+        member_map_[member->GetSymbol()] = member;
 
         if (!is_struct_) {
           UnionAddBitField(member->GetType());
@@ -1118,7 +1133,7 @@ void StructType::AddBitField(ObjectExpr *member) {
         member->GetIndexs().push_front({this, index_});
 
         members_.push_back(member);
-        scope_->InsertUsual(member);
+        member_map_[member->GetSymbol()] = member;
 
         if (!is_struct_) {
           UnionAddBitField(member->GetType());
@@ -1168,17 +1183,16 @@ std::int32_t StructType::MakeAlign(std::int32_t offset, std::int32_t align) {
   }
 }
 
-StructType::StructType(bool is_struct, const std::string &name, Scope *parent)
-    : Type{false},
+StructType::StructType(bool is_struct, const std::string &name)
+    : Type{TypeKind::kStruct, is_struct ? kStructTy : kUnionTy, false},
       is_struct_{is_struct},
-      name_{name},
-      scope_{Scope::Get(parent, kBlock)} {
+      name_{name} {
   std::string prefix{is_struct ? "struct." : "union."};
 
   if (HasName()) {
-    llvm_type_ = llvm::StructType::create(Context, prefix + name);
+    llvm_type_ = llvm::StructType::create(Context(), prefix + name);
   } else {
-    llvm_type_ = llvm::StructType::create(Context, prefix + "anon");
+    llvm_type_ = llvm::StructType::create(Context(), prefix + "anon");
   }
 }
 
@@ -1317,10 +1331,14 @@ void StructType::AddSpaceBetweenBitField() {
 FunctionType *FunctionType::Get(QualType return_type,
                                 std::vector<ObjectExpr *> params,
                                 bool is_var_args) {
-  return new (FunctionTypePool.malloc())
+  return new (AstArena().Allocate<FunctionType>())
       FunctionType{return_type, params, is_var_args};
 }
 
+bool FunctionType::classof(const Type *type) {
+  return type->GetKind() == TypeKind::kFunction;
+}
+
 std::int32_t FunctionType::GetWidth() const {
   // GNU 扩展
   return 1;
@@ -1406,7 +1424,7 @@ const std::string &FunctionType::GetName() const { return name_; }
 
 FunctionType::FunctionType(QualType return_type,
                            std::vector<ObjectExpr *> param, bool is_var_args)
-    : Type{false},
+    : Type{TypeKind::kFunction, kFunctionTy, false},
       return_type_{return_type},
       params_{param},
       is_var_args_{is_var_args} {
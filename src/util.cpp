@@ -4,6 +4,7 @@
 
 #include "util.h"
 
+#include <sys/mman.h>
 #include <unistd.h>
 #include <wait.h>
 
@@ -14,6 +15,8 @@
 #include <cstring>
 #include <filesystem>
 #include <iostream>
+#include <thread>
+#include <unordered_map>
 
 #include <llvm/Support/raw_ostream.h>
 
@@ -33,6 +36,32 @@ void InitCommandLine(int argc, char *argv[]) {
   llvm::cl::ParseCommandLineOptions(argc, argv);
 }
 
+namespace {
+
+// 源文件到其目标文件的映射, 只在 CommandLineCheck 中写入
+std::unordered_map<std::string, std::string> ObjFiles;
+
+}  // namespace
+
+// 需要链接的目标文件放在匿名的内存文件中, 链接器通过 /proc/self/fd 读取,
+// 不经过文件系统, 进程退出时自动释放
+std::string CreateObjFile(const std::string &name) {
+  auto file_name{std::filesystem::path{name}.filename().string()};
+
+  if (auto fd{memfd_create(file_name.c_str(), MFD_CLOEXEC)}; fd != -1) {
+    return "/proc/self/fd/" + std::to_string(fd);
+  }
+
+  // 不支持 memfd 时退回到临时文件
+  auto obj_file{(std::filesystem::temp_directory_path() /
+                 ("kcc-" + std::to_string(getpid()) + "-" +
+                  std::to_string(std::size(ObjFiles)) + "-" + file_name +
+                  ".o"))
+                    .string()};
+  RemoveFile.push_back(obj_file);
+  return obj_file;
+}
+
 void CommandLineCheck() {
   if (Version) {
     std::cout << "Kaiser's C Compiler\n";
@@ -44,6 +73,12 @@ void CommandLineCheck() {
   std::vector<std::string> files;
 
   for (const auto &item : InputFilePaths) {
+    // 从标准输入读取
+    if (item == "-") {
+      files.push_back(item);
+      continue;
+    }
+
     std::filesystem::path path{item};
 
     if (std::filesystem::is_directory(path)) {
@@ -67,7 +102,10 @@ void CommandLineCheck() {
         }
       }
     } else if (std::filesystem::exists(path)) {
-      if (path.filename().extension().string() == ".c") {
+      if (path.filename().extension().string() == ".c" ||
+          path.filename().extension().string() == ".i") {
+        files.push_back(item);
+      } else if (path.filename().extension().string() == ".h" && EmitPch) {
         files.push_back(item);
       } else if (path.filename().extension().string() == ".so") {
         SoFile.push_back(item);
@@ -76,7 +114,8 @@ void CommandLineCheck() {
       } else if (path.filename().extension().string() == ".o") {
         ObjFile.push_back(item);
       } else {
-        Error("the file extension must be '.c', '.so', '.a' or '.o': {}", item);
+        Error("the file extension must be '.c', '.i', '.so', '.a' or '.o': {}",
+              item);
       }
     } else {
       Error("no such file: {}", item);
@@ -87,6 +126,10 @@ void CommandLineCheck() {
     Error("no input files");
   }
 
+  if (Jobs == 0) {
+    Jobs = std::max(std::thread::hardware_concurrency(), 1U);
+  }
+
   std::sort(std::begin(files), std::end(files));
   files.erase(std::unique(std::begin(files), std::end(files)), std::end(files));
 
@@ -95,6 +138,10 @@ void CommandLineCheck() {
     InputFilePaths.push_back(item);
   }
 
+  if (!std::empty(IncludePch)) {
+    EnsureFileExists(IncludePch);
+  }
+
   for (const auto &folder : IncludePaths) {
     if (!std::filesystem::exists(folder)) {
       Error("no such directory: {}", folder);
@@ -118,12 +165,12 @@ void CommandLineCheck() {
     item = "-l" + item;
   }
 
-  for (const auto &item : InputFilePaths) {
-    ObjFile.push_back(GetObjFile(item));
-  }
-
-  for (const auto &item : InputFilePaths) {
-    RemoveFile.push_back(GetObjFile(item));
+  if (!DoNotLink()) {
+    for (const auto &item : InputFilePaths) {
+      auto obj_file{CreateObjFile(item)};
+      ObjFiles[item] = obj_file;
+      ObjFile.push_back(obj_file);
+    }
   }
 }
 
@@ -142,15 +189,19 @@ std::string GetPath() {
   return std::string(buf, end - buf);
 }
 
-decltype(std::chrono::system_clock::now()) T0;
+TimePoint T0;
+
+TimePoint Now() { return std::chrono::system_clock::now(); }
 
-void TimingStart() { T0 = std::chrono::system_clock::now(); }
+void TimingStart() { T0 = Now(); }
 
-void TimingEnd(const std::string &str) {
+void TimingEnd(const std::string &str) { TimingEnd(str, T0); }
+
+void TimingEnd(const std::string &str, TimePoint start) {
   if (Timing) {
-    auto time{std::chrono::duration_cast<std::chrono::microseconds>(
-                  std::chrono::system_clock::now() - T0)
-                  .count()};
+    auto time{
+        std::chrono::duration_cast<std::chrono::microseconds>(Now() - start)
+            .count()};
     std::cout << str << ": ";
 
     if (time > 10000000) {
@@ -171,10 +222,7 @@ void EnsureFileExists(const std::string &file_name) {
   }
 }
 
-std::string GetObjFile(const std::string &name) {
-  auto file_name{std::filesystem::path{name + ".o"}};
-  return ("/tmp" / file_name).string();
-}
+std::string GetObjFile(const std::string &name) { return ObjFiles.at(name); }
 
 std::string GetFileName(const std::string &name, std::string_view extension) {
   return std::filesystem::path{name}.replace_extension(extension).string();
@@ -192,7 +240,7 @@ bool CommandSuccess(std::int32_t status) {
 
 bool DoNotLink() {
   return Preprocess || OutputAssembly || OutputObjectFile || EmitTokens ||
-         EmitAST || EmitLLVM;
+         EmitAST || EmitLLVM || EmitPch;
 }
 
 }  // namespace kcc
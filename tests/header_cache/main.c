@@ -0,0 +1,3 @@
+#include "shared.h"
+
+int main(void) { return square(3) == 9 ? 0 : 1; }
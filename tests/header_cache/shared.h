@@ -0,0 +1,6 @@
+#ifndef KCC_TESTS_HEADER_CACHE_SHARED_H_
+#define KCC_TESTS_HEADER_CACHE_SHARED_H_
+
+int square(int x);
+
+#endif  // KCC_TESTS_HEADER_CACHE_SHARED_H_
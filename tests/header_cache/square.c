@@ -0,0 +1,3 @@
+#include "shared.h"
+
+int square(int x) { return x * x; }
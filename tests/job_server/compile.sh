@@ -0,0 +1,38 @@
+#!/bin/sh
+#
+# 用法: sh compile.sh <kcc> <可执行文件> <源文件>...
+# 模拟 make 4.4 的 fifo jobserver: 放入两个令牌后通过 MAKEFLAGS 调用 kcc,
+# 编译结束后 fifo 中应该恰好还是这两个令牌
+
+set -e
+
+kcc=$1
+executable=$2
+shift 2
+
+dir=$(mktemp -d)
+trap 'rm -rf "$dir"' EXIT
+
+mkfifo "$dir/fifo"
+# 以读写方式打开, 没有写端时读取也不会遇到文件结束
+exec 3<>"$dir/fifo"
+printf 'ab' >&3
+
+MAKEFLAGS="-j3 --jobserver-auth=fifo:$dir/fifo" "$kcc" "$@" -o "$executable"
+
+tokens=$(timeout 5 dd bs=1 count=2 <&3 2>/dev/null)
+case $tokens in
+ab | ba) ;;
+*)
+  echo "the jobserver tokens were not returned: '$tokens'"
+  exit 1
+  ;;
+esac
+
+extra=$(timeout 1 dd bs=1 count=1 <&3 2>/dev/null || true)
+if [ -n "$extra" ]; then
+  echo "kcc wrote an extra token to the jobserver: '$extra'"
+  exit 1
+fi
+
+"$executable"
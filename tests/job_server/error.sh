@@ -0,0 +1,45 @@
+#!/bin/sh
+#
+# 用法: sh error.sh <kcc> <可执行文件> <源文件>...
+# 其中一个源文件有错误: 只有该翻译单元失败, 其他翻译单元照常编译,
+# kcc 归还 jobserver 的令牌后以失败退出, 不生成可执行文件
+
+set -e
+
+kcc=$1
+executable=$2
+shift 2
+
+dir=$(mktemp -d)
+trap 'rm -rf "$dir"' EXIT
+
+mkfifo "$dir/fifo"
+exec 3<>"$dir/fifo"
+printf 'ab' >&3
+
+rm -f "$executable"
+if MAKEFLAGS="-j3 --jobserver-auth=fifo:$dir/fifo" "$kcc" "$@" -o \
+  "$executable" >"$dir/output" 2>&1; then
+  echo "kcc succeeded on a file with an error"
+  exit 1
+fi
+
+if ! grep -q "error:" "$dir/output"; then
+  echo "kcc failed without reporting the error:"
+  cat "$dir/output"
+  exit 1
+fi
+
+if [ -e "$executable" ]; then
+  echo "kcc linked an executable after an error"
+  exit 1
+fi
+
+tokens=$(timeout 5 dd bs=1 count=2 <&3 2>/dev/null)
+case $tokens in
+ab | ba) ;;
+*)
+  echo "the jobserver tokens were not returned: '$tokens'"
+  exit 1
+  ;;
+esac
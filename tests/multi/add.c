@@ -0,0 +1,3 @@
+#include "multi.h"
+
+int add(int a, int b) { return a + b; }
@@ -0,0 +1,8 @@
+#include <stdio.h>
+
+#include "multi.h"
+
+int main(void) {
+  printf("%d\n", mul(add(1, 2), 4));
+  return mul(add(1, 2), 4) == 12 ? 0 : 1;
+}
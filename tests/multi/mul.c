@@ -0,0 +1,9 @@
+#include "multi.h"
+
+int mul(int a, int b) {
+  int result = 0;
+  for (int i = 0; i < b; ++i) {
+    result = add(result, a);
+  }
+  return result;
+}
@@ -0,0 +1,7 @@
+#ifndef KCC_TESTS_MULTI_MULTI_H_
+#define KCC_TESTS_MULTI_MULTI_H_
+
+int add(int a, int b);
+int mul(int a, int b);
+
+#endif  // KCC_TESTS_MULTI_MULTI_H_
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SQUARE(x) ((x) * (x))
+#define PRINT(fmt, ...) printf(fmt, __VA_ARGS__)
+
+// 命令行中定义了这两个宏
+#undef PCH_UNDEF
+#undef PCH_REDEFINE
+#define PCH_REDEFINE 2
+
+static int square(int x) { return SQUARE(x); }
@@ -0,0 +1,14 @@
+#include "common.h"
+
+#ifdef PCH_UNDEF
+#error "PCH_UNDEF should be undefined by common.h"
+#endif
+
+#if PCH_REDEFINE != 2
+#error "PCH_REDEFINE should be redefined by common.h"
+#endif
+
+int main(void) {
+  PRINT("%d\n", square(3));
+  return SQUARE(2) == 4 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
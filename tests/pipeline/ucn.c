@@ -0,0 +1,11 @@
+// 预处理后的代码中保留了标识符中的 UCN, 流水线词法分析时需要重新扫描
+
+#include <stdlib.h>
+
+#line 10 "ucn.c"
+static int \u3042 = 1;
+
+int main(void) {
+  int a\u00e9b = 2;
+  return \u3042 + a\u00e9b == 3 && __LINE__ == 14 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
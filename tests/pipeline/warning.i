@@ -0,0 +1,2 @@
+# 1 "warning.c"
+int main(void) { return 'ab' == 0x6162 ? 0 : 1; }
@@ -0,0 +1,53 @@
+#!/bin/sh
+#
+# 用法: sh compile.sh <kcc> <源文件> <目标文件>
+# 启动编译服务器, 通过它编译同一个源文件两次并检查生成的目标文件
+# 第二次编译的子进程从服务器继承了第一次读取的头文件, 因此头文件缓存命中,
+# 本地编译时不会出现这种情况, 由此确认编译确实经过了服务器
+
+set -e
+
+kcc=$1
+source=$2
+object=$3
+
+dir=$(mktemp -d)
+server=
+trap '[ -n "$server" ] && kill "$server"; rm -rf "$dir"' EXIT
+
+KCC_SERVER_SOCKET=$dir/kcc.sock
+export KCC_SERVER_SOCKET
+
+"$kcc" -server &
+server=$!
+
+i=0
+while [ ! -S "$KCC_SERVER_SOCKET" ]; do
+  i=$((i + 1))
+  if [ "$i" -gt 100 ]; then
+    echo "the compile server did not start"
+    exit 1
+  fi
+  sleep 0.1
+done
+
+rm -f "$object"
+KCC_SERVER=1 "$kcc" "$source" -c -o "$object" -t
+rm -f "$object"
+output=$(KCC_SERVER=1 "$kcc" "$source" -c -o "$object" -t)
+echo "$output"
+
+case $output in
+*"open 1 hits, 0 misses"*) ;;
+*)
+  echo "the second compilation did not go through the compile server"
+  exit 1
+  ;;
+esac
+
+# ELF 魔数, e_type 为 ET_REL
+if [ "$(od -An -c -N 4 "$object" | tr -d ' ')" != '177ELF' ] ||
+  [ "$(od -An -tu2 -j 16 -N 2 "$object" | tr -d ' ')" != 1 ]; then
+  echo "'$object' is not an ELF relocatable file"
+  exit 1
+fi
@@ -0,0 +1,6 @@
+#ifndef KCC_TESTS_SERVER_HELLO_H_
+#define KCC_TESTS_SERVER_HELLO_H_
+
+#define HELLO 42
+
+#endif  // KCC_TESTS_SERVER_HELLO_H_
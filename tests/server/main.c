@@ -0,0 +1,3 @@
+#include "hello.h"
+
+int main(void) { return HELLO == 42 ? 0 : 1; }
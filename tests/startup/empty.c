@@ -0,0 +1 @@
+// 用于测量启动时间的空翻译单元
@@ -0,0 +1,6 @@
+#include <stdio.h>
+
+int main(void) {
+  puts("read from stdin");
+  return 0;
+}